@@ -37,6 +37,7 @@ class EscDriverBase
     void end() {}
     int attach(size_t channel, int pin, int pulse) { return 1; }
     int write(size_t channel, int pulse) { return 1; }
+    int writeAll(const int16_t * pulses, size_t n) { return n; }
     void apply() {}
     int pin(size_t channel) const { return -1; }
     uint32_t telemetry(size_t channel) const { return 0; }
@@ -68,6 +69,21 @@ class EscDriverBase
       return (value << 4) | csum;
     }
     
+    /**
+     * Same result as dshotEncode(dshotConvert(pulse), inverted), pulse is constrained to 0-2000.
+     * Checksum nibbles are folded with shifts instead of loop.
+     */
+    static uint16_t IRAM_ATTR dshotFrame(int pulse, bool inverted = false)
+    {
+      const uint32_t value = dshotConvert(pulse < 0 ? 0 : (pulse > 2000 ? 2000 : pulse)) << 1;
+      uint32_t csum = value ^ (value >> 4) ^ (value >> 8);
+      if(inverted)
+      {
+        csum = ~csum;
+      }
+      return (value << 4) | (csum & 0xf);
+    }
+
     static uint32_t IRAM_ATTR durationToBitLen(uint32_t duration, uint32_t len)
     {
       return (duration + (len >> 1)) / len;
@@ -83,7 +99,21 @@ class EscDriverBase
       return value;
     }
 
+    // same as durationToBitLen(), recip is 0xffffffff / len + 1, exact for durations below 0x8000
+    static uint32_t IRAM_ATTR durationToBitLen(uint32_t duration, uint32_t len, uint32_t recip)
+    {
+      return ((uint64_t)(duration + (len >> 1)) * recip) >> 32;
+    }
+
+    // appends run of bitLen bits of bitVal, same as pushBits()
+    static uint32_t IRAM_ATTR pushRun(uint32_t value, uint32_t bitVal, uint32_t bitLen)
+    {
+      if(bitLen >= 32) return bitVal ? 0xffffffff : 0;
+      return (value << bitLen) | (bitVal ? (1u << bitLen) - 1 : 0);
+    }
+
     /**
+     * Run lengths are computed with reciprocal of bitLen, single division per frame instead of per run.
      * @param data expected data layout (bits): duration0(15), level0(1), duration(15), level1(1)
      * @param len number of data items
      * @param bitLen duration of single bit
@@ -91,35 +121,31 @@ class EscDriverBase
      */
     static uint32_t IRAM_ATTR extractTelemetryGcr(uint32_t* data, size_t len, uint32_t bitLen)
     {
-      int bitCount = 0;
+      const uint32_t recip = 0xffffffff / bitLen + 1;
+
+      uint32_t bitCount = 0;
       uint32_t value = 0;
       for(size_t i = 0; i < len; i++)
       {
-        uint32_t duration0 = data[i] & 0x7fff;
+        const uint32_t item = data[i];
+
+        const uint32_t duration0 = item & 0x7fff;
         if(!duration0) break;
-        uint32_t level0 = (data[i] >> 15) & 0x01;
-        uint32_t len0 = durationToBitLen(duration0, bitLen);
-        if(len0)
-        {
-          value = pushBits(value, level0, len0);
-          bitCount += len0;
-        }
-
-        uint32_t duration1 = (data[i] >> 16) & 0x7fff;
+        const uint32_t len0 = durationToBitLen(duration0, bitLen, recip);
+        value = pushRun(value, (item >> 15) & 0x01, len0);
+        bitCount += len0;
+
+        const uint32_t duration1 = (item >> 16) & 0x7fff;
         if(!duration1) break;
-        uint32_t level1 = (data[i] >> 31) & 0x01;
-        uint32_t len1 = durationToBitLen(duration1, bitLen);
-        if(len1)
-        {
-          value = pushBits(value, level1, len1);
-          bitCount += len1;
-        }
+        const uint32_t len1 = durationToBitLen(duration1, bitLen, recip);
+        value = pushRun(value, item >> 31, len1);
+        bitCount += len1;
       }
 
       // fill missing bits with 1
       if(bitCount < 21)
       {
-        value = pushBits(value, 0x1, 21 - bitCount);
+        value = pushRun(value, 0x1, 21 - bitCount);
       }
 
       return value;
@@ -163,24 +189,32 @@ class EscDriverBase
     {
       value = value ^ (value >> 1); // extract gcr
 
-      constexpr uint32_t iv = 0xffffffff; // invalid code
+      constexpr uint8_t iv = 0x10; // invalid code
       // First bit is start bit so discard it.
       value &= 0xfffff;
-      static const uint32_t decode[32] = {
+      static const uint8_t decode[32] = {
         iv, iv, iv, iv, iv, iv, iv, iv, iv, 9, 10, 11, iv, 13, 14, 15,
         iv, iv,  2,  3, iv,  5,  6,  7, iv, 0,  8,  1, iv,  4, 12, iv,
       };
 
-      uint32_t decodedValue = decode[value & 0x1f];
-      decodedValue |= decode[(value >>  5) & 0x1f] <<  4;
-      decodedValue |= decode[(value >> 10) & 0x1f] <<  8;
-      decodedValue |= decode[(value >> 15) & 0x1f] << 12;
+      const uint32_t n0 = decode[value & 0x1f];
+      const uint32_t n1 = decode[(value >>  5) & 0x1f];
+      const uint32_t n2 = decode[(value >> 10) & 0x1f];
+      const uint32_t n3 = decode[(value >> 15) & 0x1f];
+
+      // reject invalid symbols before checksum
+      if((n0 | n1 | n2 | n3) & iv)
+      {
+        return INVALID_TELEMETRY_VALUE;
+      }
+
+      const uint32_t decodedValue = n0 | (n1 << 4) | (n2 << 8) | (n3 << 12);
 
       uint32_t csum = decodedValue;
       csum = csum ^ (csum >> 8); // xor bytes
       csum = csum ^ (csum >> 4); // xor nibbles
 
-      if((csum & 0xf) != 0xf || decodedValue > 0xffff)
+      if((csum & 0xf) != 0xf)
       {
         return INVALID_TELEMETRY_VALUE;
       }
@@ -237,6 +271,15 @@ class EscDriverBase
   #define ESC_DRIVER_MOTOR_TIMER ESC_DRIVER_TIMER0
   #define ESC_DRIVER_SERVO_TIMER ESC_DRIVER_TIMER1
 
+#elif defined(ESPFC_SITL)
+
+  #define ESC_CHANNEL_COUNT 4
+  #include "EscDriverSitl.h"
+  #define EscDriver EscDriverSitl
+
+  #define ESC_DRIVER_MOTOR_TIMER ESC_DRIVER_TIMER0
+  #define ESC_DRIVER_SERVO_TIMER ESC_DRIVER_TIMER1
+
 #elif defined(UNIT_TEST)
 
   #define ESC_CHANNEL_COUNT 4
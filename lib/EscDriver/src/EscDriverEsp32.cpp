@@ -110,9 +110,27 @@ int IRAM_ATTR EscDriverEsp32::write(size_t channel, int pulse)
 {
   if (channel < 0 || channel >= ESC_CHANNEL_COUNT) return 0;
   _channel[channel].pulse = pulse;
+  if (_digital) _channel[channel].dshot_frame = dshotFrame(pulse, _dshot_tlm);
   return 1;
 }
 
+int IRAM_ATTR EscDriverEsp32::writeAll(const int16_t * pulses, size_t n)
+{
+  if (n > ESC_CHANNEL_COUNT) n = ESC_CHANNEL_COUNT;
+  for (size_t i = 0; i < n; i++)
+  {
+    _channel[i].pulse = pulses[i];
+  }
+  if (_digital)
+  {
+    for (size_t i = 0; i < n; i++)
+    {
+      _channel[i].dshot_frame = dshotFrame(pulses[i], _dshot_tlm);
+    }
+  }
+  return n;
+}
+
 void IRAM_ATTR EscDriverEsp32::apply()
 {
   if (_protocol == ESC_PROTOCOL_DISABLED) return;
@@ -159,6 +177,9 @@ void EscDriverEsp32::initChannel(int i, gpio_num_t pin, int pulse)
   _channel[i].dshot_t1h = getDshotPulse(1170);
   _channel[i].dshot_t1l = getDshotPulse(500);
   _channel[i].dshot_tlm_bit_len = (_channel[i].dshot_t0h + _channel[i].dshot_t0l) * 4 / 5;
+  _channel[i].dshot_item[0] = _channel[i].dshotItem(false, _dshot_tlm);
+  _channel[i].dshot_item[1] = _channel[i].dshotItem(true, _dshot_tlm);
+  _channel[i].dshot_frame = dshotFrame(pulse, _dshot_tlm);
 
   instances[i] = this;
 
@@ -293,7 +314,7 @@ void IRAM_ATTR EscDriverEsp32::transmitOne(uint32_t i)
   if (!_channel[i].attached()) return;
   if (_digital)
   {
-    writeDshotCommand(i, _channel[i].pulse);
+    writeDshotCommand(i);
   }
   else
   {
@@ -310,7 +331,7 @@ void IRAM_ATTR EscDriverEsp32::transmitAll()
     if (!_channel[i].attached()) continue;
     if (_digital)
     {
-      writeDshotCommand(i, _channel[i].pulse);
+      writeDshotCommand(i);
     }
     else
     {
@@ -380,24 +401,16 @@ void IRAM_ATTR EscDriverEsp32::writeAnalogCommand(uint32_t channel, int32_t puls
   _rmt_fill_tx_items((rmt_channel_t)channel, _channel[channel].items, count, 0);
 }
 
-void IRAM_ATTR EscDriverEsp32::writeDshotCommand(uint32_t channel, int32_t pulse)
+void IRAM_ATTR EscDriverEsp32::writeDshotCommand(uint32_t channel)
 {
   if(_digital && _dshot_tlm)
   {
     modeTx((rmt_channel_t)channel);
   }
 
-  pulse = constrain(pulse, 0, 2000);
-  // scale to dshot commands (0 or 48-2047)
-  int value = dshotConvert(pulse);
-  uint16_t frame = dshotEncode(value, _dshot_tlm);
-
+  // frame is encoded in write()
   Slot& slot = _channel[channel];
-  for (size_t i = 0; i < DSHOT_BIT_COUNT; i++)
-  {
-    int val = (frame >> (DSHOT_BIT_COUNT - 1 - i)) & 0x01;
-    slot.setDshotBit(i, val, _dshot_tlm);
-  }
+  slot.setDshotFrame(slot.dshot_frame);
   slot.setTerminate(DSHOT_BIT_COUNT, _dshot_tlm);
 
   _rmt_fill_tx_items((rmt_channel_t)channel, slot.items, Slot::ITEM_COUNT, 0);
@@ -17,22 +17,27 @@ class EscDriverEsp32: public EscDriverBase
           items[item].val = val ? (1 << 15) : 0ul;
         }
 
-        void inline setDshotBit(int item, bool val, bool inverted)
+        // rmt item for single dshot bit, computed once per channel
+        uint32_t inline dshotItem(bool val, bool inverted) const
         {
           const uint32_t th = (val ? dshot_t1h : dshot_t0h) & DURATION_MAX;
           const uint32_t tl = (val ? dshot_t1l : dshot_t0l) & DURATION_MAX;
           if(!inverted)
           {
-            items[item].val = (th | 1 << 15) | (tl << 16 | 0 << 31);
+            return (th | 1 << 15) | (tl << 16 | 0 << 31);
           }
           else
           {
-            items[item].val = (th | 0 << 15) | (tl << 16 | 1 << 31);
+            return (th | 0 << 15) | (tl << 16 | 1 << 31);
+          }
+        }
+
+        void inline setDshotFrame(uint16_t frame)
+        {
+          for(size_t i = 0; i < DSHOT_BIT_COUNT; i++)
+          {
+            items[i].val = dshot_item[(frame >> (DSHOT_BIT_COUNT - 1 - i)) & 0x01];
           }
-          //items[item].duration0 = th;
-          //items[item].level0 = inverted ? 0 : 1;
-          //items[item].duration1 = tl;
-          //items[item].level1 = inverted ? 1 : 0;
         }
 
         void inline setDuration(int item, int duration, bool val)
@@ -75,6 +80,8 @@ class EscDriverEsp32: public EscDriverBase
         uint16_t dshot_t1h;
         uint16_t dshot_t1l;
         uint16_t dshot_tlm_bit_len;
+        uint16_t dshot_frame;
+        uint32_t dshot_item[2];
         uint32_t telemetryValue;
     };
 
@@ -83,6 +90,7 @@ class EscDriverEsp32: public EscDriverBase
     void end();
     int attach(size_t channel, int pin, int pulse);
     int write(size_t channel, int pulse);
+    int writeAll(const int16_t * pulses, size_t n);
     void apply();
     int pin(size_t channel) const;
     uint32_t telemetry(size_t channel) const;
@@ -100,7 +108,7 @@ class EscDriverEsp32: public EscDriverBase
     void transmitAll();
     void readTelemetry();
     void writeAnalogCommand(uint32_t channel, int32_t pulse);
-    void writeDshotCommand(uint32_t channel, int32_t pulse);
+    void writeDshotCommand(uint32_t channel);
     void transmitCommand(uint32_t channel);
     uint32_t getClockDivider() const;
     uint32_t getPulseMin() const;
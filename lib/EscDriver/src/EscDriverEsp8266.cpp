@@ -157,6 +157,7 @@ int EscDriverEsp8266::attach(size_t channel, int pin, int pulse)
   if(channel < 0 || channel >= ESC_CHANNEL_COUNT) return 0;
   _slots[channel].pin = pin;
   _slots[channel].pulse = usToTicks(pulse);
+  if(_protocol >= ESC_PROTOCOL_DSHOT150) _slots[channel].frame = dshotFrame(_slots[channel].pulse);
   pinMode(pin, OUTPUT);
   digitalWrite(pin, LOW);
   return 1;
@@ -177,9 +178,27 @@ int EscDriverEsp8266::write(size_t channel, int pulse)
 {
   if(channel < 0 || channel >= ESC_CHANNEL_COUNT) return 0;
   _slots[channel].pulse = usToTicks(pulse);
+  if(_protocol >= ESC_PROTOCOL_DSHOT150) _slots[channel].frame = dshotFrame(_slots[channel].pulse);
   return 1;
 }
 
+int EscDriverEsp8266::writeAll(const int16_t * pulses, size_t n)
+{
+  if(n > ESC_CHANNEL_COUNT) n = ESC_CHANNEL_COUNT;
+  for(size_t i = 0; i < n; i++)
+  {
+    _slots[i].pulse = usToTicks(pulses[i]);
+  }
+  if(_protocol >= ESC_PROTOCOL_DSHOT150)
+  {
+    for(size_t i = 0; i < n; i++)
+    {
+      _slots[i].frame = dshotFrame(_slots[i].pulse);
+    }
+  }
+  return n;
+}
+
 void EscDriverEsp8266::apply()
 {
   if(_protocol == ESC_PROTOCOL_DISABLED) return;
@@ -428,10 +447,8 @@ void EscDriverEsp8266::dshotWrite()
   {
     if(_slots[c].pin > 15 || _slots[c].pin < 0) continue;
     mask_t mask = (1U << _slots[c].pin);
-    int pulse = constrain(_slots[c].pulse, 0, 2000);
-    // scale to dshot commands (0 or 48-2047)
-    int value = dshotConvert(pulse);
-    uint16_t frame = dshotEncode(value);
+    // frame is encoded in write()
+    const uint16_t frame = _slots[c].frame;
     for(size_t i = 0; i < DSHOT_BIT_COUNT; i++)
     {
       int val = (frame >> (DSHOT_BIT_COUNT - 1 - i)) & 0x01;
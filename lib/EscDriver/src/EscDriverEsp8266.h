@@ -23,9 +23,10 @@ class EscDriverEsp8266: public EscDriverBase
     class Slot
     {
       public:
-        Slot(): pin(-1), pulse(0) {}
+        Slot(): pin(-1), pulse(0), frame(0) {}
         int pin;
         int pulse;
+        uint16_t frame;
         bool operator<(const Slot& rhs) const
         {
           if(!active()) return false;
@@ -54,6 +55,7 @@ class EscDriverEsp8266: public EscDriverBase
     void end();
     int attach(size_t channel, int pin, int pulse) IRAM_ATTR;
     int write(size_t channel, int pulse) IRAM_ATTR;
+    int writeAll(const int16_t * pulses, size_t n) IRAM_ATTR;
     void apply() IRAM_ATTR;
     int pin(size_t channel) const;
     uint32_t telemetry(size_t channel) const;
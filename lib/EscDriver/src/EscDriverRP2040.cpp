@@ -22,6 +22,7 @@ int EscDriverRP2040::attach(size_t channel, int pin, int pulse)
 
   _slots[channel].pin = pin;
   _slots[channel].pulse = usToTicks(pulse);
+  if(isDshot()) _slots[channel].frame = dshotFrame(_slots[channel].pulse);
   _slots[channel].slice = pwm_gpio_to_slice_num(pin);
   _slots[channel].channel = pwm_gpio_to_channel(pin);
 
@@ -100,12 +101,35 @@ int EscDriverRP2040::write(size_t channel, int pulse)
 {
   if(channel >= ESC_CHANNEL_COUNT) return 0;
   _slots[channel].pulse = usToTicks(pulse);
+  if(isDshot()) _slots[channel].frame = dshotFrame(_slots[channel].pulse);
   return 1;
 }
 
+int EscDriverRP2040::writeAll(const int16_t * pulses, size_t n)
+{
+  if(n > ESC_CHANNEL_COUNT) n = ESC_CHANNEL_COUNT;
+  for(size_t i = 0; i < n; i++)
+  {
+    _slots[i].pulse = usToTicks(pulses[i]);
+  }
+  if(isDshot())
+  {
+    for(size_t i = 0; i < n; i++)
+    {
+      _slots[i].frame = dshotFrame(_slots[i].pulse);
+    }
+  }
+  return n;
+}
+
+bool EscDriverRP2040::isDshot() const
+{
+  return _protocol >= ESC_PROTOCOL_DSHOT150 && _protocol <= ESC_PROTOCOL_DSHOT600;
+}
+
 void EscDriverRP2040::apply()
 {
-  if(_protocol >= ESC_PROTOCOL_DSHOT150 && _protocol <= ESC_PROTOCOL_DSHOT600)
+  if(isDshot())
   {
     dshotWriteDMA();
     return;
@@ -231,9 +255,8 @@ void EscDriverRP2040::dshotWriteDMA()
   {
     if(!_slots[i].active()) continue;
 
-    uint16_t pulse = constrain(_slots[i].pulse, 0, 2000);
-    uint16_t value = dshotConvert(pulse);
-    uint16_t frame = dshotEncode(value);
+    // frame is encoded in write()
+    const uint16_t frame = _slots[i].frame;
 
     int slice = _slots[i].slice;
     int channel = _slots[i].channel;
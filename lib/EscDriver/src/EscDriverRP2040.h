@@ -23,9 +23,10 @@ class EscDriverRP2040: public EscDriverBase
     class Slot
     {
       public:
-        Slot(): pin(-1), pulse(0), slice(0), channel(0), drive(false) {}
+        Slot(): pin(-1), pulse(0), frame(0), slice(0), channel(0), drive(false) {}
         int pin;
         int pulse;
+        uint16_t frame;
         int slice;
         int channel;
         bool drive;
@@ -42,6 +43,7 @@ class EscDriverRP2040: public EscDriverBase
     void end();
     int attach(size_t channel, int pin, int pulse) IRAM_ATTR;
     int write(size_t channel, int pulse) IRAM_ATTR;
+    int writeAll(const int16_t * pulses, size_t n) IRAM_ATTR;
     int pin(size_t channel) const;
     uint32_t telemetry(size_t channel) const;
     void apply() IRAM_ATTR;
@@ -52,6 +54,7 @@ class EscDriverRP2040: public EscDriverBase
     uint32_t nsToDshotTicks(uint32_t ns);
     void dshotWriteDMA();
     bool isSliceDriven(int slice);
+    bool isDshot() const;
     void clearDmaBuffer();
 
     EscProtocol _protocol;
@@ -0,0 +1,157 @@
+#if defined(ESPFC_SITL)
+
+#include "EscDriverSitl.h"
+#include <algorithm>
+
+EscDriverSitl * EscDriverSitl::instances[] = {NULL, NULL};
+
+EscDriverSitl::EscDriverSitl(): _dshot(false), _telemetry(false), _timer(ESC_DRIVER_TIMER0), _lastApply(0), _applyCount(0) {}
+
+int EscDriverSitl::begin(const EscConfig& conf)
+{
+  _dshot = conf.protocol >= ESC_PROTOCOL_DSHOT150 && conf.protocol <= ESC_PROTOCOL_DSHOT600;
+  _telemetry = _dshot && conf.dshotTelemetry;
+  _timer = (EscDriverTimer)std::min(std::max(conf.timer, 0), (int)ESC_DRIVER_TIMER_COUNT - 1);
+  _lastApply = micros();
+  _applyCount = 0;
+  instances[_timer] = this;
+  return 1;
+}
+
+void EscDriverSitl::end()
+{
+  for(size_t i = 0; i < ESC_CHANNEL_COUNT; i++)
+  {
+    _slots[i] = Slot();
+  }
+  if(instances[_timer] == this) instances[_timer] = NULL;
+}
+
+int EscDriverSitl::attach(size_t channel, int pin, int pulse)
+{
+  if(channel >= ESC_CHANNEL_COUNT) return 0;
+  _slots[channel].pin = pin;
+  _slots[channel].pulse = pulse;
+  return 1;
+}
+
+int EscDriverSitl::write(size_t channel, int pulse)
+{
+  if(channel >= ESC_CHANNEL_COUNT) return 0;
+  _slots[channel].pulse = pulse;
+  return 1;
+}
+
+int EscDriverSitl::writeAll(const int16_t * pulses, size_t n)
+{
+  if(n > ESC_CHANNEL_COUNT) n = ESC_CHANNEL_COUNT;
+  for(size_t i = 0; i < n; i++)
+  {
+    _slots[i].pulse = pulses[i];
+  }
+  return n;
+}
+
+void EscDriverSitl::apply()
+{
+  uint32_t now = micros();
+  float dt = (now - _lastApply) * 0.000001f;
+  _lastApply = now;
+  _applyCount++;
+
+  float alpha = std::min(dt / (MOTOR_TAU + dt), 1.f);
+  for(size_t i = 0; i < ESC_CHANNEL_COUNT; i++)
+  {
+    Slot& slot = _slots[i];
+    if(!slot.active()) continue;
+    float target = throttle(i) * ERPM_MAX;
+    slot.erpm += (target - slot.erpm) * alpha;
+  }
+}
+
+int EscDriverSitl::pin(size_t channel) const
+{
+  if(channel >= ESC_CHANNEL_COUNT) return -1;
+  return _slots[channel].pin;
+}
+
+uint32_t EscDriverSitl::telemetry(size_t channel) const
+{
+  if(!_telemetry || channel >= ESC_CHANNEL_COUNT) return 0;
+  return encodeTelemetryGcr(lrintf(_slots[channel].erpm));
+}
+
+int EscDriverSitl::pulse(size_t channel) const
+{
+  if(channel >= ESC_CHANNEL_COUNT) return 0;
+  return _slots[channel].pulse;
+}
+
+float EscDriverSitl::throttle(size_t channel) const
+{
+  if(channel >= ESC_CHANNEL_COUNT) return 0;
+  int pulse = _slots[channel].pulse;
+  if(pulse <= 1000) return 0.f; // stopped or dshot command
+  return std::min((pulse - 1000) * 0.001f, 1.f);
+}
+
+float EscDriverSitl::erpm(size_t channel) const
+{
+  if(channel >= ESC_CHANNEL_COUNT) return 0;
+  return _slots[channel].erpm;
+}
+
+uint32_t EscDriverSitl::applyCount() const
+{
+  return _applyCount;
+}
+
+EscDriverSitl * EscDriverSitl::instance(EscDriverTimer timer)
+{
+  if(timer < 0 || timer >= ESC_DRIVER_TIMER_COUNT) return NULL;
+  return instances[timer];
+}
+
+/**
+ * Inverse of gcrToRawValue(), produces raw gcr frame as it would be received from esc.
+ */
+uint32_t EscDriverSitl::encodeTelemetryGcr(uint32_t erpm)
+{
+  // eRPM to period, encoded as eeem mmmm mmmm
+  uint32_t value = 0x0fff;
+  if(erpm)
+  {
+    uint32_t period = (1000000 * 60 / 100 + erpm / 2) / erpm;
+    uint32_t exponent = 0;
+    while(period > 0x1ff && exponent < 7)
+    {
+      period >>= 1;
+      exponent++;
+    }
+    if(period <= 0x1ff) value = (exponent << 9) | period; // otherwise too slow, report stopped
+  }
+
+  // checksum, xor of all nibbles must be 0xf
+  uint32_t csum = value ^ (value >> 4) ^ (value >> 8);
+  value = (value << 4) | (~csum & 0xf);
+
+  static const uint32_t encode[16] = {
+    0x19, 0x1b, 0x12, 0x13, 0x1d, 0x15, 0x16, 0x17, 0x1a, 0x09, 0x0a, 0x0b, 0x1e, 0x0d, 0x0e, 0x0f,
+  };
+
+  uint32_t gcr = encode[value & 0xf];
+  gcr |= encode[(value >>  4) & 0xf] <<  5;
+  gcr |= encode[(value >>  8) & 0xf] << 10;
+  gcr |= encode[(value >> 12) & 0xf] << 15;
+
+  // revert value ^ (value >> 1)
+  gcr ^= gcr >> 1;
+  gcr ^= gcr >> 2;
+  gcr ^= gcr >> 4;
+  gcr ^= gcr >> 8;
+  gcr ^= gcr >> 16;
+
+  return gcr;
+}
+
+#endif // ESPFC_SITL
@@ -0,0 +1,69 @@
+#ifndef _ESC_DRIVER_SITL_H_
+#define _ESC_DRIVER_SITL_H_
+
+#if defined(ESPFC_SITL)
+
+#include "EscDriver.h"
+
+enum EscDriverTimer
+{
+  ESC_DRIVER_TIMER0,
+  ESC_DRIVER_TIMER1,
+  ESC_DRIVER_TIMER_COUNT
+};
+
+/**
+ * Simulated ESC driver for software-in-the-loop builds.
+ * Stores written pulses and spins up first order motor model,
+ * which is reported back as GCR encoded eRPM telemetry.
+ */
+class EscDriverSitl: public EscDriverBase
+{
+  public:
+    class Slot
+    {
+      public:
+        Slot(): pin(-1), pulse(0), erpm(0) {}
+        int pin;
+        int pulse;
+        float erpm; // eRPM / 100
+        inline bool active() const { return pin != -1; }
+    };
+
+    EscDriverSitl();
+
+    int begin(const EscConfig& conf);
+    void end();
+    int attach(size_t channel, int pin, int pulse);
+    int write(size_t channel, int pulse);
+    int writeAll(const int16_t * pulses, size_t n);
+    void apply();
+    int pin(size_t channel) const;
+    uint32_t telemetry(size_t channel) const;
+
+    int pulse(size_t channel) const;
+    float throttle(size_t channel) const;
+    float erpm(size_t channel) const;
+    uint32_t applyCount() const;
+
+    static EscDriverSitl * instance(EscDriverTimer timer);
+
+    static uint32_t encodeTelemetryGcr(uint32_t erpm);
+
+    static constexpr float ERPM_MAX = 2800.f; // eRPM / 100 at full throttle
+    static constexpr float MOTOR_TAU = 0.02f; // spin up time constant [s]
+
+  private:
+    bool _dshot;
+    bool _telemetry;
+    EscDriverTimer _timer;
+    uint32_t _lastApply;
+    uint32_t _applyCount;
+    Slot _slots[ESC_CHANNEL_COUNT];
+
+    static EscDriverSitl * instances[ESC_DRIVER_TIMER_COUNT];
+};
+
+#endif // ESPFC_SITL
+
+#endif
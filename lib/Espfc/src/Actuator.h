@@ -223,9 +223,7 @@ class Actuator
       int scale = Math::clamp((int)_model.state.inputUs[AXIS_THRUST], 1000, 2000);
       if(_model.config.gyroDynLpfFilter.cutoff > 0) {
         int gyroFreq = Math::map(scale, 1000, 2000, _model.config.gyroDynLpfFilter.cutoff, _model.config.gyroDynLpfFilter.freq);
-        for(size_t i = 0; i <= AXIS_YAW; i++) {
-          _model.state.gyroFilter[i].reconfigure(gyroFreq);
-        }
+        _model.state.gyroFilter.reconfigure(gyroFreq);
       }
       if(_model.config.dtermDynLpfFilter.cutoff > 0) {
         int dtermFreq = Math::map(scale, 1000, 2000, _model.config.dtermDynLpfFilter.cutoff, _model.config.dtermDynLpfFilter.freq);
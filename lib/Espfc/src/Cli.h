@@ -8,6 +8,7 @@
 #include "Model.h"
 #include "Hardware.h"
 #include "Logger.h"
+#include "Utils/FilterLatency.h"
 #include "Device/GyroDevice.h"
 #include "Hal/Pgm.h"
 
@@ -427,6 +428,7 @@ class Cli
         Param(PSTR("gyro_dyn_notch_count"), &c.dynamicFilter.width),
         Param(PSTR("gyro_dyn_notch_min"), &c.dynamicFilter.min_freq),
         Param(PSTR("gyro_dyn_notch_max"), &c.dynamicFilter.max_freq),
+        Param(PSTR("gyro_dyn_notch_budget"), &c.dynamicFilter.budget),
         Param(PSTR("gyro_rpm_harmonics"), &c.rpmFilterHarmonics),
         Param(PSTR("gyro_rpm_q"), &c.rpmFilterQ),
         Param(PSTR("gyro_rpm_min_freq"), &c.rpmFilterMinFreq),
@@ -435,6 +437,7 @@ class Cli
         Param(PSTR("gyro_rpm_weight_2"), &c.rpmFilterWeights[1]),
         Param(PSTR("gyro_rpm_weight_3"), &c.rpmFilterWeights[2]),
         Param(PSTR("gyro_rpm_tlm_lpf_freq"), &c.rpmFilterFreqLpf),
+        Param(PSTR("gyro_notch_ramp"), &c.gyroNotchRamp),
         Param(PSTR("gyro_offset_x"), &c.gyroBias[0]),
         Param(PSTR("gyro_offset_y"), &c.gyroBias[1]),
         Param(PSTR("gyro_offset_z"), &c.gyroBias[2]),
@@ -616,6 +619,8 @@ class Cli
         Param(PSTR("mixer_throttle_limit_type"), &c.output.throttleLimitType, throtleLimitTypeChoices),
         Param(PSTR("mixer_throttle_limit_percent"), &c.output.throttleLimitPercent),
         Param(PSTR("mixer_output_limit"), &c.output.motorLimit),
+        Param(PSTR("mixer_thrust_linear"), &c.output.thrustLinear),
+        Param(PSTR("mixer_vbat_sag_compensation"), &c.output.vbatSagCompensation),
 
         Param(PSTR("output_motor_protocol"), &c.output.protocol, protocolChoices),
         Param(PSTR("output_motor_async"), &c.output.async),
@@ -647,6 +652,22 @@ class Cli
 #endif
 #if ESPFC_OUTPUT_COUNT > 7
         Param(PSTR("output_7"), &c.output.channel[7]),
+#endif
+        Param(PSTR("output_motor_scale_0"), &c.output.motorScale[0]),
+        Param(PSTR("output_motor_scale_1"), &c.output.motorScale[1]),
+        Param(PSTR("output_motor_scale_2"), &c.output.motorScale[2]),
+        Param(PSTR("output_motor_scale_3"), &c.output.motorScale[3]),
+#if ESPFC_OUTPUT_COUNT > 4
+        Param(PSTR("output_motor_scale_4"), &c.output.motorScale[4]),
+#endif
+#if ESPFC_OUTPUT_COUNT > 5
+        Param(PSTR("output_motor_scale_5"), &c.output.motorScale[5]),
+#endif
+#if ESPFC_OUTPUT_COUNT > 6
+        Param(PSTR("output_motor_scale_6"), &c.output.motorScale[6]),
+#endif
+#if ESPFC_OUTPUT_COUNT > 7
+        Param(PSTR("output_motor_scale_7"), &c.output.motorScale[7]),
 #endif
 #ifdef ESPFC_INPUT
         Param(PSTR("pin_input_rx"), &c.pin[PIN_INPUT_RX]),
@@ -875,7 +896,8 @@ class Cli
           PSTR("available commands:"),
           PSTR(" help"), PSTR(" dump"), PSTR(" get param"), PSTR(" set param value ..."), PSTR(" cal [gyro]"),
           PSTR(" defaults"), PSTR(" save"), PSTR(" reboot"), PSTR(" scaler"), PSTR(" mixer"),
-          PSTR(" stats"), PSTR(" status"), PSTR(" devinfo"), PSTR(" version"), PSTR(" logs"),
+          PSTR(" stats [reset]"), PSTR(" status"), PSTR(" devinfo"), PSTR(" version"), PSTR(" logs"),
+          PSTR(" filter latency [freq ...]"), PSTR(" sched [reset]"),
           //PSTR(" load"), PSTR(" eeprom"),
           //PSTR(" fsinfo"), PSTR(" fsformat"), PSTR(" log"),
           NULL
@@ -975,6 +997,7 @@ class Cli
           if(strcmp_P(cmd.args[1], _params[i].name) == 0)
           {
             _params[i].update(cmd.args);
+            if(_params[i].type == PARAM_MIXER) _model.state.mixerChanged = true;
             print(_params[i], s);
             found = true;
             break;
@@ -1196,6 +1219,62 @@ class Cli
           if(mixer.mixes[i].src == MIXER_SOURCE_NULL) break;
         }
       }
+      else if(strcmp_P(cmd.args[0], PSTR("filter")) == 0)
+      {
+        if(!cmd.args[1] || strcmp_P(cmd.args[1], PSTR("latency")) != 0)
+        {
+          s.println(F("usage: filter latency [freq ...]"));
+          return;
+        }
+
+        static const size_t FREQ_MAX = CLI_ARGS_SIZE - 2;
+        float freqs[FREQ_MAX];
+        size_t count = 0;
+        for(size_t i = 2; i < CLI_ARGS_SIZE && cmd.args[i]; i++)
+        {
+          float f = String(cmd.args[i]).toFloat();
+          if(f > 0.f) freqs[count++] = f;
+        }
+        if(!count)
+        {
+          for(; count < Utils::FilterLatency::DEFAULT_FREQ_COUNT; count++) freqs[count] = Utils::FilterLatency::defaultFreq(count);
+        }
+
+        Utils::FilterLatency latency(_model);
+        float delays[Utils::FilterLatency::STAGE_COUNT][FREQ_MAX];
+        float gyro[FREQ_MAX], dterm[FREQ_MAX];
+        for(size_t i = 0; i < count; i++)
+        {
+          latency.compute(freqs[i]);
+          for(size_t j = 0; j < Utils::FilterLatency::STAGE_COUNT; j++) delays[j][i] = latency.delay[j];
+          gyro[i] = latency.gyro();
+          dterm[i] = latency.dterm();
+        }
+
+        s.print(F("freq [Hz]:"));
+        for(size_t i = 0; i < count; i++) { s.print(' '); s.print(freqs[i], 0); }
+        s.println();
+        for(size_t j = 0; j < Utils::FilterLatency::STAGE_COUNT; j++)
+        {
+          if(delays[j][0] == 0.f) continue; // stage not active
+          s.print(Utils::FilterLatency::name(j));
+          s.print(F(" [us]:"));
+          for(size_t i = 0; i < count; i++) { s.print(' '); s.print(delays[j][i] * 1e6f, 1); }
+          s.println();
+        }
+        s.print(F("gyro [us]:"));
+        for(size_t i = 0; i < count; i++) { s.print(' '); s.print(gyro[i] * 1e6f, 1); }
+        s.println();
+        s.print(F("gyro [deg]:"));
+        for(size_t i = 0; i < count; i++) { s.print(' '); s.print(Utils::FilterLatency::phase(gyro[i], freqs[i]), 1); }
+        s.println();
+        s.print(F("dterm [us]:"));
+        for(size_t i = 0; i < count; i++) { s.print(' '); s.print(dterm[i] * 1e6f, 1); }
+        s.println();
+        s.print(F("dterm [deg]:"));
+        for(size_t i = 0; i < count; i++) { s.print(' '); s.print(Utils::FilterLatency::phase(dterm[i], freqs[i]), 1); }
+        s.println();
+      }
       else if(strcmp_P(cmd.args[0], PSTR("status")) == 0)
       {
         printVersion(s);
@@ -1281,6 +1360,12 @@ class Cli
       }
       else if(strcmp_P(cmd.args[0], PSTR("stats")) == 0)
       {
+        if(cmd.args[1] && strcmp_P(cmd.args[1], PSTR("reset")) == 0)
+        {
+          _model.state.stats.reset();
+          s.println(F("OK"));
+          return;
+        }
         printVersion(s);
         s.println();
         printStats(s);
@@ -1291,7 +1376,7 @@ class Cli
           int time = lrintf(_model.state.stats.getTime(c));
           float load = _model.state.stats.getLoad(c);
           int freq = lrintf(_model.state.stats.getFreq(c));
-          int real = lrintf(_model.state.stats.getReal(c));
+          float real = _model.state.stats.getReal(c);
           if(freq == 0) continue;
 
           s.print(FPSTR(_model.state.stats.getName(c)));
@@ -1303,7 +1388,7 @@ class Cli
 
           if(real < 100) s.print(' ');
           if(real < 10) s.print(' ');
-          s.print(real);
+          s.print(real, 1);
           s.print("us/i,  ");
 
           if(load < 10) s.print(' ');
@@ -1323,6 +1408,51 @@ class Cli
         s.print(_model.state.stats.getCpuLoad(), 1);
         s.print(F("%"));
         s.println();
+        s.println();
+
+        s.println(F("  [us]: min p50 p90 p99 p99.9 max"));
+        for(int i = 0; i < COUNTER_COUNT; ++i)
+        {
+          StatCounter c = (StatCounter)i;
+          const Stats& stats = _model.state.stats;
+          if(!stats.getSamples(c)) continue;
+
+          s.print(FPSTR(stats.getName(c)));
+          s.print(':');
+          s.print(' '); s.print(stats.getMin(c), 1);
+          s.print(' '); s.print(stats.getPercentile(c, 0.5f), 1);
+          s.print(' '); s.print(stats.getPercentile(c, 0.9f), 1);
+          s.print(' '); s.print(stats.getPercentile(c, 0.99f), 1);
+          s.print(' '); s.print(stats.getPercentile(c, 0.999f), 1);
+          s.print(' '); s.print(stats.getMax(c), 1);
+          s.println();
+        }
+      }
+      else if(strcmp_P(cmd.args[0], PSTR("sched")) == 0)
+      {
+        Scheduler& scheduler = _model.state.scheduler;
+        if(cmd.args[1] && strcmp_P(cmd.args[1], PSTR("reset")) == 0)
+        {
+          scheduler.resetStats();
+          s.println(F("OK"));
+          return;
+        }
+        s.print(F("period: "));
+        s.print(scheduler.period());
+        s.print(F("us, cycles: "));
+        s.println(scheduler.cycles());
+        s.println(F("task rate[Hz] slot prio budget[us] max[us] runs overrun deferred missed"));
+        for(size_t i = 0; i < scheduler.count(); i++)
+        {
+          const Scheduler::Task& t = scheduler.task(i);
+          if(!t.denom) continue;
+          const uint32_t values[] = {
+            _model.state.gyroTimer.rate / t.denom, t.slot, t.priority, t.budget, t.maxTime, t.runs, t.overruns, t.deferrals, t.misses,
+          };
+          s.print(FPSTR(t.name));
+          for(size_t j = 0; j < sizeof(values) / sizeof(values[0]); j++) { s.print(' '); s.print(values[j]); }
+          s.println();
+        }
       }
       else if(strcmp_P(cmd.args[0], PSTR("reboot")) == 0 || strcmp_P(cmd.args[0], PSTR("exit")) == 0)
       {
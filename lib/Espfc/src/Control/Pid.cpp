@@ -1,5 +1,6 @@
 #include "Pid.h"
 #include "Math/Utils.h"
+#include "Math/FixedPoint.h"
 #include "Utils/MemoryHelper.h"
 
 namespace Espfc {
@@ -35,15 +36,7 @@ float FAST_CODE_ATTR Pid::update(float setpoint, float measurement)
   {
     if(!outputSaturated)
     {
-      // I-term relax
-      if(itermRelax)
-      {
-        const bool increasing = (iTerm > 0 && iTermError > 0) || (iTerm < 0 && iTermError < 0);
-        const bool incrementOnly = itermRelax == ITERM_RELAX_RP_INC || itermRelax == ITERM_RELAX_RPY_INC;
-        itermRelaxBase = setpoint - itermRelaxFilter.update(setpoint);
-        itermRelaxFactor = std::max(0.0f, 1.0f - std::abs(Math::toDeg(itermRelaxBase)) * 0.025f); // (itermRelaxBase / 40)
-        if(!incrementOnly || increasing) iTermError *= itermRelaxFactor;
-      }
+      if(itermRelax) relaxIterm(setpoint);
       iTerm += Ki * iScale * iTermError * dt;
       iTerm = Math::clamp(iTerm, -iLimit, iLimit);
     }
@@ -57,10 +50,7 @@ float FAST_CODE_ATTR Pid::update(float setpoint, float measurement)
   if(Kd > 0.f && dScale > 0.f)
   {
     //dTerm = (Kd * dScale * (((error - prevError) * dGamma) + (prevMeasurement - measure) * (1.f - dGamma)) / dt);
-    dTerm = Kd * dScale * ((prevMeasurement - measurement) * rate);
-    dTerm = dtermNotchFilter.update(dTerm);
-    dTerm = dtermFilter.update(dTerm);
-    dTerm = dtermFilter2.update(dTerm);
+    dTerm = filterDterm(Kd * dScale * ((prevMeasurement - measurement) * rate));
   }
   else
   {
@@ -2,6 +2,9 @@
 
 #include <cstdint>
 #include "Filter.h"
+#include "FilterFixed.h"
+#include "Math/Utils.h"
+#include "Math/FixedPoint.h"
 
 // bataflight scalers
 #define PTERM_SCALE_BETAFLIGHT 0.032029f
@@ -32,6 +35,13 @@ enum ItermRelaxType {
 
 namespace Control {
 
+// integer filters on targets without FPU, enabled by build flag
+#if defined(ESPFC_FIXED_POINT)
+typedef FilterFixed PidFilter;
+#else
+typedef Filter PidFilter;
+#endif
+
 class Pid
 {
   public:
@@ -39,6 +49,33 @@ class Pid
     void begin();
     float update(float setpoint, float measure);
 
+    // scale iTermError by iterm relax factor
+    inline void relaxIterm(float setpoint)
+    {
+      const bool increasing = (iTerm > 0 && iTermError > 0) || (iTerm < 0 && iTermError < 0);
+      const bool incrementOnly = itermRelax == ITERM_RELAX_RP_INC || itermRelax == ITERM_RELAX_RPY_INC;
+      itermRelaxBase = setpoint - itermRelaxFilter.update(setpoint);
+      itermRelaxFactor = std::max(0.0f, 1.0f - std::abs(Math::toDeg(itermRelaxBase)) * 0.025f); // (itermRelaxBase / 40)
+      if(!incrementOnly || increasing) iTermError *= itermRelaxFactor;
+    }
+
+    // dterm notch and low pass chain
+    inline float filterDterm(float v)
+    {
+#if defined(ESPFC_FIXED_POINT)
+      // whole chain in integer domain, converted once
+      int32_t fixed = Math::toQ16(v);
+      fixed = dtermNotchFilter.updateFixed(fixed);
+      fixed = dtermFilter.updateFixed(fixed);
+      fixed = dtermFilter2.updateFixed(fixed);
+      return Math::fromQ16(fixed);
+#else
+      v = dtermNotchFilter.update(v);
+      v = dtermFilter.update(v);
+      return dtermFilter2.update(v);
+#endif
+    }
+
     float rate;
     float dt;
 
@@ -63,12 +100,12 @@ class Pid
     float dTerm;
     float fTerm;
 
-    Filter dtermFilter;
-    Filter dtermFilter2;
-    Filter dtermNotchFilter;
-    Filter ptermFilter;
-    Filter ftermFilter;
-    Filter itermRelaxFilter;
+    PidFilter dtermFilter;
+    PidFilter dtermFilter2;
+    PidFilter dtermNotchFilter;
+    PidFilter ptermFilter;
+    PidFilter ftermFilter;
+    PidFilter itermRelaxFilter;
 
     float prevMeasurement;
     float prevError;
@@ -0,0 +1,180 @@
+#include <cstring>
+#include "Pid3.h"
+#include "Math/Utils.h"
+#include "Math/FixedPoint.h"
+#include "Utils/MemoryHelper.h"
+
+namespace Espfc {
+
+namespace Control {
+
+namespace {
+
+#if defined(ESPFC_FIXED_POINT)
+
+// disabled filters are skipped without a call
+inline int32_t applyFilter(PidFilter& f, int32_t v)
+{
+  return f.type() == FILTER_NONE ? v : f.updateFixed(v);
+}
+
+inline int32_t applyDtermFilters(Pid& p, int32_t v)
+{
+  v = applyFilter(p.dtermNotchFilter, v);
+  v = applyFilter(p.dtermFilter, v);
+  return applyFilter(p.dtermFilter2, v);
+}
+
+// 1 / 40 [deg/s] in rad/s, q16
+constexpr int32_t ITERM_RELAX_SCALE = (int32_t)(180.0f * Math::invPi() * 0.025f * (1 << Math::Q16_BITS) + 0.5f);
+
+// same as Pid::relaxIterm()
+inline int32_t relaxIterm(Pid& p, int32_t setpoint, int32_t iTermError, int32_t iTerm)
+{
+  const bool increasing = (iTerm > 0 && iTermError > 0) || (iTerm < 0 && iTermError < 0);
+  const bool incrementOnly = p.itermRelax == ITERM_RELAX_RP_INC || p.itermRelax == ITERM_RELAX_RPY_INC;
+  const int32_t base = setpoint - p.itermRelaxFilter.updateFixed(setpoint);
+  const int32_t factor = std::max((int32_t)0, (1 << Math::Q16_BITS) - Math::mulFixed<Math::Q16_BITS>(std::abs(base), ITERM_RELAX_SCALE));
+  p.itermRelaxBase = Math::fromQ16(base);
+  p.itermRelaxFactor = Math::fromQ16(factor);
+  return !incrementOnly || increasing ? Math::mulFixed<Math::Q16_BITS>(iTermError, factor) : iTermError;
+}
+
+#else
+
+// disabled filters are skipped without a call
+inline float applyFilter(PidFilter& f, float v)
+{
+  return f.type() == FILTER_NONE ? v : f.update(v);
+}
+
+inline float applyDtermFilters(Pid& p, float v)
+{
+  v = applyFilter(p.dtermNotchFilter, v);
+  v = applyFilter(p.dtermFilter, v);
+  return applyFilter(p.dtermFilter2, v);
+}
+
+#endif
+
+}
+
+#if defined(ESPFC_FIXED_POINT)
+
+Pid3::Pid3(Pid * pids): _pid(pids)
+{
+  for(size_t i = 0; i < AXES; i++)
+  {
+    // nan source forces first build
+    std::memset(_gainSource[i], 0xff, sizeof(_gainSource[i]));
+    syncGains(i);
+    _iTerm[i] = Math::toQ30(_pid[i].iTerm);
+    _iTermOut[i] = _pid[i].iTerm;
+    _prevMeasurement[i] = Math::toQ16(_pid[i].prevMeasurement);
+    _prevSetpoint[i] = Math::toQ16(_pid[i].prevSetpoint);
+  }
+}
+
+void FAST_CODE_ATTR Pid3::syncGains(size_t i)
+{
+  const Pid& p = _pid[i];
+  const float source[GAIN_SOURCES] = { p.Kp, p.Ki, p.Kd, p.Kf, p.pScale, p.iScale, p.dScale, p.fScale, p.rate, p.dt, p.iLimit, p.oLimit };
+  if(std::memcmp(source, _gainSource[i], sizeof(source)) == 0) return;
+  std::memcpy(_gainSource[i], source, sizeof(source));
+
+  // zero gain disables term, same conditions as Pid::update()
+  _kp[i] = Math::toQ20(p.Kp * p.pScale);
+  _ki[i] = p.Ki > 0.f && p.iScale > 0.f ? Math::toQ30(p.Ki * p.iScale * p.dt) : 0;
+  _kd[i] = p.Kd > 0.f && p.dScale > 0.f ? Math::toQ20(p.Kd * p.dScale * p.rate) : 0;
+  _kf[i] = p.Kf > 0.f && p.fScale > 0.f ? Math::toQ20(p.Kf * p.fScale * p.rate) : 0;
+  _iLimit[i] = Math::toQ30(p.iLimit);
+  _oLimit[i] = Math::toQ16(p.oLimit);
+}
+
+void FAST_CODE_ATTR Pid3::update(const float * setpoint, const float * measurement, float * output)
+{
+  for(size_t i = 0; i < AXES; i++)
+  {
+    Pid& p = _pid[i];
+    syncGains(i);
+    // iterm zeroed by controller when disarmed or on low throttle
+    if(p.iTerm != _iTermOut[i]) _iTerm[i] = Math::toQ30(p.iTerm);
+
+    const int32_t sp = Math::toQ16(setpoint[i]);
+    const int32_t m = Math::toQ16(measurement[i]);
+    const int32_t error = sp - m;
+
+    const int32_t pTerm = applyFilter(p.ptermFilter, Math::roundFixed<Math::Q20_BITS>((int64_t)_kp[i] * error));
+
+    int32_t iTermError = error;
+    if(_ki[i] == 0) _iTerm[i] = 0;
+    else if(!p.outputSaturated)
+    {
+      if(p.itermRelax) iTermError = relaxIterm(p, sp, iTermError, _iTerm[i]);
+      const int64_t iTerm = _iTerm[i] + (int64_t)Math::roundFixed<Math::Q16_BITS>((int64_t)_ki[i] * iTermError);
+      _iTerm[i] = (int32_t)Math::clamp(iTerm, -(int64_t)_iLimit[i], (int64_t)_iLimit[i]);
+    }
+
+    const int32_t dTerm = _kd[i] == 0 ? 0 : applyDtermFilters(p, Math::roundFixed<Math::Q20_BITS>((int64_t)_kd[i] * (_prevMeasurement[i] - m)));
+    const int32_t fTerm = _kf[i] == 0 ? 0 : applyFilter(p.ftermFilter, Math::roundFixed<Math::Q20_BITS>((int64_t)_kf[i] * (sp - _prevSetpoint[i])));
+    _prevMeasurement[i] = m;
+    _prevSetpoint[i] = sp;
+
+    const int64_t sum = (int64_t)pTerm + Math::roundFixed<Math::Q30_BITS - Math::Q16_BITS>(_iTerm[i]) + dTerm + fTerm;
+    output[i] = Math::fromQ16((int32_t)Math::clamp(sum, -(int64_t)_oLimit[i], (int64_t)_oLimit[i]));
+
+    // float copies for blackbox, msp and debug
+    p.error = Math::fromQ16(error);
+    p.iTermError = Math::fromQ16(iTermError);
+    p.pTerm = Math::fromQ16(pTerm);
+    p.iTerm = _iTermOut[i] = Math::fromFixed<Math::Q30_BITS>(_iTerm[i]);
+    p.dTerm = Math::fromQ16(dTerm);
+    p.fTerm = Math::fromQ16(fTerm);
+    p.prevMeasurement = measurement[i];
+    p.prevError = p.error;
+    p.prevSetpoint = setpoint[i];
+  }
+}
+
+#else
+
+Pid3::Pid3(Pid * pids): _pid(pids) {}
+
+void FAST_CODE_ATTR Pid3::update(const float * setpoint, const float * measurement, float * output)
+{
+  // zero gain disables term, same conditions as Pid::update()
+  float ki[AXES], kd[AXES], kf[AXES];
+  for(size_t i = 0; i < AXES; i++)
+  {
+    const Pid& p = _pid[i];
+    ki[i] = p.Ki > 0.f && p.iScale > 0.f ? p.Ki * p.iScale : 0.f;
+    kd[i] = p.Kd > 0.f && p.dScale > 0.f ? p.Kd * p.dScale : 0.f;
+    kf[i] = p.Kf > 0.f && p.fScale > 0.f ? p.Kf * p.fScale : 0.f;
+  }
+
+  for(size_t i = 0; i < AXES; i++)
+  {
+    Pid& p = _pid[i];
+    p.error = setpoint[i] - measurement[i];
+    p.pTerm = applyFilter(p.ptermFilter, p.Kp * p.error * p.pScale);
+    p.iTermError = p.error;
+    if(ki[i] == 0.f) p.iTerm = 0;
+    else if(!p.outputSaturated)
+    {
+      if(p.itermRelax) p.relaxIterm(setpoint[i]);
+      p.iTerm = Math::clamp(p.iTerm + ki[i] * p.iTermError * p.dt, -p.iLimit, p.iLimit);
+    }
+    p.dTerm = kd[i] == 0.f ? 0.f : applyDtermFilters(p, kd[i] * ((p.prevMeasurement - measurement[i]) * p.rate));
+    p.fTerm = kf[i] == 0.f ? 0.f : applyFilter(p.ftermFilter, kf[i] * (setpoint[i] - p.prevSetpoint) * p.rate);
+    p.prevMeasurement = measurement[i];
+    p.prevError = p.error;
+    p.prevSetpoint = setpoint[i];
+    output[i] = Math::clamp(p.pTerm + p.iTerm + p.dTerm + p.fTerm, -p.oLimit, p.oLimit);
+  }
+}
+
+#endif
+
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include "Control/Pid.h"
+
+namespace Espfc {
+
+namespace Control {
+
+/**
+ * Roll, pitch and yaw inner loop pid evaluated together.
+ * Gains, state and filters stay in per axis Pid objects, so blackbox, msp and scalers read and write them as before.
+ * Term enable checks and scaled gains are evaluated for all axes into parallel arrays first,
+ * then each axis runs p, i, d and f without nested checks, disabled filters are skipped without a call.
+ * Result is the same as Pid::update() called for each axis.
+ * With ESPFC_FIXED_POINT terms are computed and summed in integers, signals in q16, gains in q20, iterm in q30,
+ * filters run in integer domain without conversions, floats are only converted at input and written back for telemetry.
+ */
+class Pid3
+{
+  public:
+    static constexpr size_t AXES = 3;
+
+    explicit Pid3(Pid * pids);
+
+    // output is not scaled by tpa
+    void update(const float * setpoint, const float * measurement, float * output);
+
+  private:
+    Pid * _pid;
+#if defined(ESPFC_FIXED_POINT)
+    static constexpr size_t GAIN_SOURCES = 12;
+    void syncGains(size_t axis);
+
+    // fixed gains are rebuilt only when any float gain, scale or limit changes
+    float _gainSource[AXES][GAIN_SOURCES];
+    int32_t _kp[AXES];     // q20
+    int32_t _ki[AXES];     // q30, includes dt
+    int32_t _kd[AXES];     // q20, includes rate
+    int32_t _kf[AXES];     // q20, includes rate
+    int32_t _iLimit[AXES]; // q30
+    int32_t _oLimit[AXES]; // q16
+    int32_t _iTerm[AXES];  // q30
+    float _iTermOut[AXES]; // last iTerm written to pid, other value means it was reset outside
+    int32_t _prevMeasurement[AXES]; // q16
+    int32_t _prevSetpoint[AXES];    // q16
+#endif
+};
+
+}
+
+}
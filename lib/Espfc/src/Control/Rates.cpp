@@ -3,6 +3,13 @@
 
 namespace Espfc {
 
+namespace {
+
+constexpr float INPUT_LIMIT = 0.995f;
+constexpr float LUT_SCALE = Rates::LUT_SIZE / INPUT_LIMIT;
+
+}
+
 void Rates::begin(const InputConfig& config)
 {
   rateType = (RateType)config.rateType;
@@ -13,11 +20,28 @@ void Rates::begin(const InputConfig& config)
     rates[i] = config.superRate[i];
     rateLimit[i] = config.rateLimit[i];
   }
+  for(size_t i = 0; i < 3; i++)
+  {
+    for(size_t j = 0; j <= LUT_SIZE; j++)
+    {
+      _lut[i][j] = getSetpointExact(i, j / LUT_SCALE);
+    }
+  }
 }
 
 float FAST_CODE_ATTR Rates::getSetpoint(const int axis, float input) const
 {
-  input = Math::clamp(input, -0.995f, 0.995f); // limit input
+  input = Math::clamp(input, -INPUT_LIMIT, INPUT_LIMIT);
+  const float pos = std::abs(input) * LUT_SCALE;
+  const size_t i = std::min((size_t)pos, LUT_SIZE - 1);
+  const float * lut = _lut[axis];
+  const float result = lut[i] + (lut[i + 1] - lut[i]) * (pos - i);
+  return input < 0.f ? -result : result;
+}
+
+float Rates::getSetpointExact(const int axis, float input) const
+{
+  input = Math::clamp(input, -INPUT_LIMIT, INPUT_LIMIT); // limit input
   const float inputAbs = fabsf(input);
   float result = 0;
   switch(rateType)
@@ -36,7 +60,7 @@ float FAST_CODE_ATTR Rates::getSetpoint(const int axis, float input) const
   return Math::toRad(Math::clamp(result, -(float)rateLimit[axis], (float)rateLimit[axis]));
 }
 
-float FAST_CODE_ATTR Rates::betaflight(const int axis, float rcCommandf, const float rcCommandfAbs) const
+float Rates::betaflight(const int axis, float rcCommandf, const float rcCommandfAbs) const
 {
   if (this->rcExpo[axis])
   {
@@ -59,7 +83,7 @@ float FAST_CODE_ATTR Rates::betaflight(const int axis, float rcCommandf, const f
   return angleRate;
 }
 
-float FAST_CODE_ATTR Rates::raceflight(const int axis, float rcCommandf, const float rcCommandfAbs) const
+float Rates::raceflight(const int axis, float rcCommandf, const float rcCommandfAbs) const
 {
   // -1.0 to 1.0 ranged and curved
   rcCommandf = ((1.0f + 0.01f * this->rcExpo[axis] * (rcCommandf * rcCommandf - 1.0f)) * rcCommandf);
@@ -70,7 +94,7 @@ float FAST_CODE_ATTR Rates::raceflight(const int axis, float rcCommandf, const f
   return angleRate;
 }
 
-float FAST_CODE_ATTR Rates::kiss(const int axis, float rcCommandf, const float rcCommandfAbs) const
+float Rates::kiss(const int axis, float rcCommandf, const float rcCommandfAbs) const
 {
   const float rcCurvef = this->rcExpo[axis] / 100.0f;
 
@@ -81,7 +105,7 @@ float FAST_CODE_ATTR Rates::kiss(const int axis, float rcCommandf, const float r
   return kissAngle;
 }
 
-float FAST_CODE_ATTR Rates::actual(const int axis, float rcCommandf, const float rcCommandfAbs) const
+float Rates::actual(const int axis, float rcCommandf, const float rcCommandfAbs) const
 {
   float expof = this->rcExpo[axis] / 100.0f;
   expof = rcCommandfAbs * (power5(rcCommandf) * expof + rcCommandf * (1 - expof));
@@ -93,7 +117,7 @@ float FAST_CODE_ATTR Rates::actual(const int axis, float rcCommandf, const float
   return angleRate;
 }
 
-float FAST_CODE_ATTR Rates::quick(const int axis, float rcCommandf, const float rcCommandfAbs) const
+float Rates::quick(const int axis, float rcCommandf, const float rcCommandfAbs) const
 {
   const float rcRate = this->rcRates[axis] * 2;
   const float maxDPS = std::max(this->rates[axis] * 10.f, rcRate);
@@ -6,6 +6,11 @@
 #define SETPOINT_RATE_LIMIT 1998.0f
 #define RC_RATE_INCREMENTAL 14.54f
 
+// rate curve table segments per axis
+#ifndef ESPFC_RATES_LUT_SIZE
+#define ESPFC_RATES_LUT_SIZE 128
+#endif
+
 namespace Espfc
 {
 
@@ -17,11 +22,21 @@ enum RateType {
   RATES_TYPE_QUICK,
 };
 
+/**
+ * Rate curves are evaluated at begin() into per axis tables, getSetpoint() interpolates linearly between entries.
+ * Curves are odd functions of input, so tables cover positive half only.
+ */
 class Rates
 {
   public:
+    static constexpr size_t LUT_SIZE = ESPFC_RATES_LUT_SIZE;
+    static_assert(LUT_SIZE >= 2, "rates table too small");
+
     void begin(const InputConfig& config);
+    // table lookup [rad/s]
     float getSetpoint(const int axis, float input) const;
+    // curve evaluation [rad/s], used to build tables
+    float getSetpointExact(const int axis, float input) const;
 
   private:
     float betaflight(const int axis, float rcCommandf, const float rcCommandfAbs) const;
@@ -51,6 +66,7 @@ class Rates
     uint8_t rcRates[3];
     uint8_t rates[3];
     int16_t rateLimit[3];
+    float _lut[3][LUT_SIZE + 1];
 };
 
 } // namespace Espfc
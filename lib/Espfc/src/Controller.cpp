@@ -3,7 +3,7 @@
 
 namespace Espfc {
 
-Controller::Controller(Model& model): _model(model) {}
+Controller::Controller(Model& model): _model(model), _innerPid(model.state.innerPid) {}
 
 int Controller::begin()
 {
@@ -14,6 +14,11 @@ int Controller::begin()
 
 int FAST_CODE_ATTR Controller::update()
 {
+#if defined(ESPFC_MULTI_CORE)
+  // pid and mixer work on the same coherent input, even if input task updates it meanwhile
+  _model.state.inputSample.receive(_model.state.inputSampled);
+#endif
+
   uint32_t startTime = 0;
   if(_model.config.debugMode == DEBUG_PIDLOOP)
   {
@@ -63,14 +68,14 @@ void Controller::outerLoopRobot()
 
   if(true || _model.isActive(MODE_ANGLE))
   {
-    angle = _model.state.input[AXIS_PITCH] * radians(_model.config.angleLimit);
+    angle = _model.state.inputSampled.input[AXIS_PITCH] * radians(_model.config.angleLimit);
   }
   else
   {
-    angle = _model.state.outerPid[AXIS_PITCH].update(_model.state.input[AXIS_PITCH], speed) * radians(_model.config.angleRateLimit);
+    angle = _model.state.outerPid[AXIS_PITCH].update(_model.state.inputSampled.input[AXIS_PITCH], speed) * radians(_model.config.angleRateLimit);
   }
   _model.state.desiredAngle.set(AXIS_PITCH, angle);
-  _model.state.desiredRate[AXIS_YAW] = _model.state.input[AXIS_YAW] * radians(_model.config.angleRateLimit);
+  _model.state.desiredRate[AXIS_YAW] = _model.state.inputSampled.input[AXIS_YAW] * radians(_model.config.angleRateLimit);
 
   if(_model.config.debugMode == DEBUG_ANGLERATE)
   {
@@ -111,8 +116,8 @@ void FAST_CODE_ATTR Controller::outerLoop()
   if(_model.isActive(MODE_ANGLE))
   {
     _model.state.desiredAngle = VectorFloat(
-      _model.state.input[AXIS_ROLL] * radians(_model.config.angleLimit),
-      _model.state.input[AXIS_PITCH] * radians(_model.config.angleLimit),
+      _model.state.inputSampled.input[AXIS_ROLL] * radians(_model.config.angleLimit),
+      _model.state.inputSampled.input[AXIS_PITCH] * radians(_model.config.angleLimit),
       _model.state.angle[AXIS_YAW]
     );
     _model.state.desiredRate[AXIS_ROLL]  = _model.state.outerPid[AXIS_ROLL].update(_model.state.desiredAngle[AXIS_ROLL], _model.state.angle[AXIS_ROLL]);
@@ -123,11 +128,11 @@ void FAST_CODE_ATTR Controller::outerLoop()
   }
   else
   {
-    _model.state.desiredRate[AXIS_ROLL] = calculateSetpointRate(AXIS_ROLL, _model.state.input[AXIS_ROLL]);
-    _model.state.desiredRate[AXIS_PITCH] = calculateSetpointRate(AXIS_PITCH, _model.state.input[AXIS_PITCH]);
+    _model.state.desiredRate[AXIS_ROLL] = calculateSetpointRate(AXIS_ROLL, _model.state.inputSampled.input[AXIS_ROLL]);
+    _model.state.desiredRate[AXIS_PITCH] = calculateSetpointRate(AXIS_PITCH, _model.state.inputSampled.input[AXIS_PITCH]);
   }
-  _model.state.desiredRate[AXIS_YAW] = calculateSetpointRate(AXIS_YAW, _model.state.input[AXIS_YAW]);
-  _model.state.desiredRate[AXIS_THRUST] = _model.state.input[AXIS_THRUST];
+  _model.state.desiredRate[AXIS_YAW] = calculateSetpointRate(AXIS_YAW, _model.state.inputSampled.input[AXIS_YAW]);
+  _model.state.desiredRate[AXIS_THRUST] = _model.state.inputSampled.input[AXIS_THRUST];
 
   if(_model.config.debugMode == DEBUG_ANGLERATE)
   {
@@ -141,9 +146,11 @@ void FAST_CODE_ATTR Controller::outerLoop()
 void FAST_CODE_ATTR Controller::innerLoop()
 {
   const float tpaFactor = getTpaFactor();
+  const float measurement[] = { _model.state.gyro[AXIS_ROLL], _model.state.gyro[AXIS_PITCH], _model.state.gyro[AXIS_YAW] };
+  _innerPid.update(_model.state.desiredRate, measurement, _model.state.output);
   for(size_t i = 0; i <= AXIS_YAW; ++i)
   {
-    _model.state.output[i] = _model.state.innerPid[i].update(_model.state.desiredRate[i], _model.state.gyro[i]) * tpaFactor;
+    _model.state.output[i] *= tpaFactor;
     //_model.state.debug[i] = lrintf(_model.state.innerPid[i].fTerm * 1000);
   }
   _model.state.output[AXIS_THRUST] = _model.state.desiredRate[AXIS_THRUST];
@@ -160,14 +167,14 @@ void FAST_CODE_ATTR Controller::innerLoop()
 float Controller::getTpaFactor() const
 {
   if(_model.config.tpaScale == 0) return 1.f;
-  float t = Math::clamp(_model.state.inputUs[AXIS_THRUST], (float)_model.config.tpaBreakpoint, 2000.f);
+  float t = Math::clamp(_model.state.inputSampled.inputUs[AXIS_THRUST], (float)_model.config.tpaBreakpoint, 2000.f);
   return Math::map(t, (float)_model.config.tpaBreakpoint, 2000.f, 1.f, 1.f - ((float)_model.config.tpaScale * 0.01f));
 }
 
 void Controller::resetIterm()
 {
   if(!_model.isActive(MODE_ARMED)   // when not armed
-    || (!_model.isAirModeActive() && _model.config.lowThrottleZeroIterm && _model.isThrottleLow()) // on low throttle (not in air mode)
+    || (!_model.isAirModeActive() && _model.config.lowThrottleZeroIterm && _model.isThrottleLow(_model.state.inputSampled.inputUs)) // on low throttle (not in air mode)
   )
   {
     for(size_t i = 0; i < AXES; i++)
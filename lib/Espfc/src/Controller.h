@@ -3,6 +3,7 @@
 
 #include "Model.h"
 #include "Control/Rates.h"
+#include "Control/Pid3.h"
 
 namespace Espfc {
 
@@ -26,6 +27,7 @@ class Controller
     Model& _model;
     Rates _rates;
     Filter _speedFilter;
+    Control::Pid3 _innerPid;
 };
 
 }
@@ -0,0 +1,59 @@
+#if defined(ESPFC_SITL)
+
+#include <Arduino.h>
+#include "BusSitl.h"
+
+namespace Espfc {
+
+namespace Device {
+
+BusType BusSitl::getType() const { return BUS_SPI; }
+
+int8_t BusSitl::read(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data)
+{
+  return readFast(devAddr, regAddr, length, data);
+}
+
+int8_t BusSitl::readFast(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data)
+{
+  const uint8_t * regs = registers();
+  for(size_t i = 0; i < length; i++)
+  {
+    data[i] = regs[(regAddr + i) % REGISTER_COUNT];
+  }
+  (void)devAddr;
+  return length;
+}
+
+bool BusSitl::write(uint8_t devAddr, uint8_t regAddr, uint8_t length, const uint8_t* data)
+{
+  poke(regAddr, data, length);
+  (void)devAddr;
+  return true;
+}
+
+void BusSitl::poke(uint8_t regAddr, const uint8_t * data, size_t length)
+{
+  uint8_t * regs = registers();
+  for(size_t i = 0; i < length; i++)
+  {
+    regs[(regAddr + i) % REGISTER_COUNT] = data[i];
+  }
+}
+
+uint8_t BusSitl::peek(uint8_t regAddr)
+{
+  return registers()[regAddr % REGISTER_COUNT];
+}
+
+uint8_t * BusSitl::registers()
+{
+  static uint8_t regs[REGISTER_COUNT] = {0};
+  return regs;
+}
+
+}
+
+}
+
+#endif
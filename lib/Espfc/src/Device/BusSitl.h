@@ -0,0 +1,43 @@
+#pragma once
+
+#if defined(ESPFC_SITL)
+
+#include <cstdint>
+#include <cstddef>
+#include "BusDevice.h"
+
+namespace Espfc {
+
+namespace Device {
+
+/**
+ * Simulated SPI bus backed by a register file shared by all instances.
+ * Device drivers read and write registers as on a real chip,
+ * simulator injects sensor data with poke().
+ */
+class BusSitl: public BusDevice
+{
+  public:
+    static const size_t REGISTER_COUNT = 128;
+
+    BusType getType() const override;
+
+    int8_t read(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data) override;
+
+    int8_t readFast(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data) override;
+
+    bool write(uint8_t devAddr, uint8_t regAddr, uint8_t length, const uint8_t* data) override;
+
+    static void poke(uint8_t regAddr, const uint8_t * data, size_t length);
+
+    static uint8_t peek(uint8_t regAddr);
+
+  private:
+    static uint8_t * registers();
+};
+
+}
+
+}
+
+#endif
@@ -0,0 +1,68 @@
+#if defined(ESPFC_SITL)
+
+#include "InputSitl.h"
+#include "Utils/MemoryHelper.h"
+
+namespace Espfc {
+
+namespace Device {
+
+int InputSitl::begin()
+{
+  Frame& f = frame();
+  for(size_t i = 0; i < CHANNELS; i++)
+  {
+    f.channels[i] = 0;
+  }
+  f.newData = false;
+  return 1;
+}
+
+InputStatus FAST_CODE_ATTR InputSitl::update()
+{
+  Frame& f = frame();
+  if(!f.newData) return INPUT_IDLE;
+  f.newData = false;
+  return INPUT_RECEIVED;
+}
+
+uint16_t FAST_CODE_ATTR InputSitl::get(uint8_t i) const
+{
+  return frame().channels[i];
+}
+
+void FAST_CODE_ATTR InputSitl::get(uint16_t * data, size_t len) const
+{
+  const Frame& f = frame();
+  const uint16_t * src = f.channels;
+  while(len--)
+  {
+    *data++ = *src++;
+  }
+}
+
+size_t InputSitl::getChannelCount() const { return CHANNELS; }
+
+bool InputSitl::needAverage() const { return false; }
+
+void InputSitl::send(const uint16_t * data, size_t len)
+{
+  Frame& f = frame();
+  for(size_t i = 0; i < CHANNELS && i < len; i++)
+  {
+    f.channels[i] = data[i];
+  }
+  f.newData = true;
+}
+
+InputSitl::Frame& InputSitl::frame()
+{
+  static Frame f;
+  return f;
+}
+
+}
+
+}
+
+#endif
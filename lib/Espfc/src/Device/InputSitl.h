@@ -0,0 +1,43 @@
+#pragma once
+
+#if defined(ESPFC_SITL)
+
+#include "Device/InputDevice.h"
+#include <cstdint>
+#include <cstddef>
+
+namespace Espfc {
+
+namespace Device {
+
+/**
+ * Simulated receiver, frames are pushed by simulator with send().
+ */
+class InputSitl: public InputDevice
+{
+  public:
+    int begin();
+    InputStatus update() override;
+    uint16_t get(uint8_t i) const override;
+    void get(uint16_t * data, size_t len) const override;
+    size_t getChannelCount() const override;
+    bool needAverage() const override;
+
+    static void send(const uint16_t * data, size_t len);
+
+    static const size_t CHANNELS = 16;
+
+  private:
+    struct Frame
+    {
+      uint16_t channels[CHANNELS];
+      bool newData;
+    };
+    static Frame& frame();
+};
+
+}
+
+}
+
+#endif
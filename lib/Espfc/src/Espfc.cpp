@@ -29,6 +29,7 @@ int Espfc::begin()
   _controller.begin();
   _blackbox.begin();    // requires _serial.begin(), _actuator.begin()
   _buzzer.begin();
+  beginScheduler();     // requires _model.begin()
   _model.state.buzzer.push(BUZZER_SYSTEM_INIT);
 
   return 1;
@@ -46,61 +47,21 @@ int FAST_CODE_ATTR Espfc::update(bool externalTrigger)
   }
   Stats::Measure measure(_model.state.stats, COUNTER_CPU_0);
 
-#if defined(ESPFC_MULTI_CORE)
-
-  _sensor.read();
-  if(_model.state.inputTimer.syncTo(_model.state.gyroTimer, 1u))
-  {
-    _input.update();
-  }
-  if(_model.state.actuatorTimer.check())
-  {
-    _actuator.update();
-  }
-
-  _serial.update();
-  _buzzer.update();
+  _model.state.scheduler.run(_model.state.gyroTimer.iteration);
   _model.state.stats.update();
 
-#else
-
-  _sensor.update();
-  if(_model.state.loopTimer.syncTo(_model.state.gyroTimer))
-  {
-    _controller.update();
-    if(_model.state.mixerTimer.syncTo(_model.state.loopTimer))
-    {
-      _mixer.update();
-    }
-    _blackbox.update();
-    if(_model.state.inputTimer.syncTo(_model.state.gyroTimer, 1u))
-    {
-      _input.update();
-    }
-    if(_model.state.actuatorTimer.check())
-    {
-      _actuator.update();
-    }
-  }
-  _sensor.updateDelayed();
-
-  _serial.update();
-  _buzzer.update();
-  _model.state.stats.update();
-#endif
-
   return 1;
 }
 
 // other task
-int FAST_CODE_ATTR Espfc::updateOther()
+int FAST_CODE_ATTR Espfc::updateOther(uint32_t timeout)
 {
 #if defined(ESPFC_MULTI_CORE)
-  if(_model.state.appQueue.isEmpty())
+  Event e;
+  if(!_model.state.appQueue.receive(e, timeout))
   {
     return 0;
   }
-  Event e = _model.state.appQueue.receive();
 
   Stats::Measure measure(_model.state.stats, COUNTER_CPU_1);
 
@@ -131,5 +92,128 @@ int FAST_CODE_ATTR Espfc::updateOther()
   return 1;
 }
 
+// budgets [us] are typical worst case on esp32 at 240MHz, they only drive placement and deferral
+void Espfc::beginScheduler()
+{
+  Scheduler& s = _model.state.scheduler;
+  const ModelState& state = _model.state;
+  const uint32_t gyroRate = state.gyroTimer.rate;
+  // polled devices keep own timers, scheduler only limits how often they are asked
+  const uint32_t pollDenom = std::max(gyroRate / Math::alignToClock(gyroRate, 1000), (uint32_t)1);
+  const uint32_t actuatorDenom = std::max(gyroRate / state.actuatorTimer.rate, (uint32_t)1);
+
+#if defined(ESPFC_MULTI_CORE)
+  // pid, mixer, blackbox and fusion run on other core, triggered by events from gyro and accel tasks
+  s.add(PSTR("gyro"),     taskGyro,     this, 1, 0, 30, 0);
+  s.add(PSTR("input"),    taskInput,    this, state.inputTimer.denom, 1, 15, 1);
+  s.add(PSTR("accel"),    taskAccel,    this, state.accelTimer.denom, 1, 15);
+#else
+  s.add(PSTR("gyro"),     taskGyro,     this, 1, 0, 30, 0);
+  s.add(PSTR("pid"),      taskPid,      this, state.loopTimer.denom, 0, 20, 0);
+  s.add(PSTR("mixer"),    taskMixer,    this, state.loopTimer.denom * state.mixerTimer.denom, 0, 15, 0);
+  s.add(PSTR("blackbox"), taskBlackbox, this, state.loopTimer.denom, 0, 25, 0);
+  s.add(PSTR("gyro_a"),   taskGyroPost, this, 1, 0, 10, 0);
+  s.add(PSTR("input"),    taskInput,    this, state.inputTimer.denom, 1, 15, 1);
+  const int accel = s.add(PSTR("accel"), taskAccel, this, state.accelTimer.denom, 1, 15);
+  s.follow(accel, PSTR("imu"), taskFusion, this, 1, 25);
+#endif
+  s.add(PSTR("mag"),      taskMag,      this, pollDenom, 2, 30);
+  s.add(PSTR("baro"),     taskBaro,     this, pollDenom, 2, 30);
+  s.add(PSTR("voltage"),  taskVoltage,  this, pollDenom, 2, 15);
+  s.add(PSTR("actuator"), taskActuator, this, actuatorDenom, 2, 10);
+  s.add(PSTR("serial"),   taskSerial,   this, 1, 3, 40);
+  s.add(PSTR("buzzer"),   taskBuzzer,   this, 1, 3, 5);
+
+  s.begin(state.gyroTimer.interval);
+}
+
+void FAST_CODE_ATTR Espfc::taskGyro(void * ctx)
+{
+  Espfc * fc = static_cast<Espfc*>(ctx);
+#if defined(ESPFC_MULTI_CORE)
+  fc->_sensor.read();
+#else
+  fc->_sensor.update();
+#endif
+}
+
+void FAST_CODE_ATTR Espfc::taskPid(void * ctx)
+{
+  Espfc * fc = static_cast<Espfc*>(ctx);
+  fc->_model.state.loopTimer.update(micros());
+  fc->_controller.update();
+}
+
+void FAST_CODE_ATTR Espfc::taskMixer(void * ctx)
+{
+  Espfc * fc = static_cast<Espfc*>(ctx);
+  fc->_model.state.mixerTimer.update(micros());
+  fc->_mixer.update();
+}
+
+void FAST_CODE_ATTR Espfc::taskBlackbox(void * ctx)
+{
+  static_cast<Espfc*>(ctx)->_blackbox.update();
+}
+
+void FAST_CODE_ATTR Espfc::taskGyroPost(void * ctx)
+{
+  static_cast<Espfc*>(ctx)->_sensor.postLoop();
+}
+
+void Espfc::taskInput(void * ctx)
+{
+  Espfc * fc = static_cast<Espfc*>(ctx);
+  fc->_model.state.inputTimer.update(micros());
+  fc->_input.update();
+}
+
+void Espfc::taskAccel(void * ctx)
+{
+  Espfc * fc = static_cast<Espfc*>(ctx);
+  fc->_model.state.accelTimer.update(micros());
+  fc->_sensor.accel();
+#if defined(ESPFC_MULTI_CORE)
+  fc->_model.state.appQueue.send(Event(EVENT_ACCEL_READ));
+#endif
+}
+
+void Espfc::taskFusion(void * ctx)
+{
+  static_cast<Espfc*>(ctx)->_sensor.fusion();
+}
+
+void Espfc::taskMag(void * ctx)
+{
+  static_cast<Espfc*>(ctx)->_sensor.mag();
 }
 
+void Espfc::taskBaro(void * ctx)
+{
+  static_cast<Espfc*>(ctx)->_sensor.baro();
+}
+
+void Espfc::taskVoltage(void * ctx)
+{
+  Espfc * fc = static_cast<Espfc*>(ctx);
+  if(fc->_sensor.voltage()) fc->_mixer.updateCurve();
+}
+
+void Espfc::taskActuator(void * ctx)
+{
+  Espfc * fc = static_cast<Espfc*>(ctx);
+  fc->_model.state.actuatorTimer.update(micros());
+  fc->_actuator.update();
+}
+
+void Espfc::taskSerial(void * ctx)
+{
+  static_cast<Espfc*>(ctx)->_serial.update();
+}
+
+void Espfc::taskBuzzer(void * ctx)
+{
+  static_cast<Espfc*>(ctx)->_buzzer.update();
+}
+
+}
@@ -21,14 +21,39 @@ class Espfc
     int load();
     int begin();
     int update(bool externalTrigger = false);
-    int updateOther();
+    // timeout [us], 0 returns immediately when there is no event
+    int updateOther(uint32_t timeout = 0);
 
     int getGyroInterval() const
     {
       return _model.state.gyroTimer.interval;
     }
 
+#if defined(ESPFC_SITL)
+    Model& getModel()
+    {
+      return _model;
+    }
+#endif
+
   private:
+    void beginScheduler();
+
+    static void taskGyro(void * ctx);
+    static void taskPid(void * ctx);
+    static void taskMixer(void * ctx);
+    static void taskBlackbox(void * ctx);
+    static void taskGyroPost(void * ctx);
+    static void taskInput(void * ctx);
+    static void taskAccel(void * ctx);
+    static void taskFusion(void * ctx);
+    static void taskMag(void * ctx);
+    static void taskBaro(void * ctx);
+    static void taskVoltage(void * ctx);
+    static void taskActuator(void * ctx);
+    static void taskSerial(void * ctx);
+    static void taskBuzzer(void * ctx);
+
     Model _model;
     Hardware _hardware;
     Controller _controller;
@@ -1,6 +1,7 @@
 #include <cmath>
 #include "Filter.h"
 #include "Math/Utils.h"
+#include "Math/SinCos.h"
 #include "Utils/MemoryHelper.h"
 
 // Quick median filter implementation
@@ -126,6 +127,20 @@ void FilterStateBiquad::init(BiquadFilterType filterType, float rate, float freq
   this->a2 = a2 / a0;
 }
 
+void FAST_CODE_ATTR FilterStateBiquad::initNotch(float rate, float freq, float q)
+{
+  float sn, cs;
+  Math::sinCos((2.0f * Math::pi() * freq) / rate, sn, cs);
+  const float alpha = sn / (2.0f * q);
+  const float a0inv = 1.f / (1.f + alpha);
+
+  b0 = a0inv;
+  b1 = -2.f * cs * a0inv;
+  b2 = a0inv;
+  a1 = b1;
+  a2 = (1.f - alpha) * a0inv;
+}
+
 void FAST_CODE_ATTR FilterStateBiquad::reconfigure(const FilterStateBiquad& from)
 {
   b0 = from.b0;
@@ -275,6 +290,52 @@ float FAST_CODE_ATTR FilterStatePt3::update(float n)
   return v[2];
 }
 
+// group delay of p0 + p1 z^-1 + p2 z^-2, real part of sum(k * pk * z^-k) / sum(pk * z^-k) at z = e^jw
+static double polyGroupDelay(double p0, double p1, double p2, double omega)
+{
+  const double c1 = std::cos(omega), s1 = std::sin(omega);
+  const double c2 = std::cos(2.0 * omega), s2 = std::sin(2.0 * omega);
+  const double sr = p0 + p1 * c1 + p2 * c2, si = -(p1 * s1 + p2 * s2);
+  const double tr = p1 * c1 + 2.0 * p2 * c2, ti = -(p1 * s1 + 2.0 * p2 * s2);
+  const double mag = sr * sr + si * si;
+  // zero on unit circle, only symmetric numerators get here, those have linear phase
+  if(mag < 1e-18) return p2 != 0.0 ? 1.0 : 0.5;
+  return (tr * sr + ti * si) / mag;
+}
+
+float getFilterGroupDelay(FilterType type, const float * c, float weight, float omega)
+{
+  switch(type)
+  {
+    case FILTER_PT1:
+    case FILTER_PT2:
+    case FILTER_PT3:
+    {
+      // cascade of identical sections k / (1 - (1 - k) z^-1)
+      const int order = type == FILTER_PT3 ? 3 : (type == FILTER_PT2 ? 2 : 1);
+      return -order * polyGroupDelay(1.0, c[0] - 1.0, 0.0, omega);
+    }
+    case FILTER_BIQUAD:
+    case FILTER_NOTCH:
+    case FILTER_BPF:
+    case FILTER_FO:
+      return polyGroupDelay(c[0], c[1], c[2], omega) - polyGroupDelay(1.0, c[3], c[4], omega);
+    case FILTER_NOTCH_DF1:
+    {
+      // w * B / A + (1 - w) = (w * B + (1 - w) * A) / A
+      const double w = weight, iw = 1.0 - weight;
+      return polyGroupDelay(w * c[0] + iw, w * c[1] + iw * c[3], w * c[2] + iw * c[4], omega) - polyGroupDelay(1.0, c[3], c[4], omega);
+    }
+    case FILTER_FIR2:
+      return 0.5f;
+    case FILTER_MEDIAN3:
+      return 1.0f;
+    case FILTER_NONE:
+    default:
+      return 0.0f;
+  }
+}
+
 Filter::Filter(): _conf(FilterConfig(FILTER_NONE, 0)) {}
 
 void Filter::begin()
@@ -471,4 +532,35 @@ float FAST_CODE_ATTR Filter::getNotchQ(float freq, float cutoff)
   return sqrtf(std::pow(2.f, octaves)) / (std::pow(2.f, octaves) - 1);
 }
 
+float Filter::getGroupDelay(float freq) const
+{
+  if(_conf.type == FILTER_NONE || _rate <= 0) return 0.0f;
+  float c[5] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+  switch(_conf.type)
+  {
+    case FILTER_PT1:
+      c[0] = _state.pt1.k;
+      break;
+    case FILTER_PT2:
+      c[0] = _state.pt2.k;
+      break;
+    case FILTER_PT3:
+      c[0] = _state.pt3.k;
+      break;
+    case FILTER_BIQUAD:
+    case FILTER_NOTCH:
+    case FILTER_NOTCH_DF1:
+    case FILTER_BPF:
+      c[0] = _state.bq.b0; c[1] = _state.bq.b1; c[2] = _state.bq.b2;
+      c[3] = _state.bq.a1; c[4] = _state.bq.a2;
+      break;
+    case FILTER_FO:
+      c[0] = _state.fo.b0; c[1] = _state.fo.b1; c[3] = _state.fo.a1;
+      break;
+    default:
+      break;
+  }
+  return getFilterGroupDelay((FilterType)_conf.type, c, _output_weight, 2.0f * Math::pi() * freq / _rate) / _rate;
+}
+
 }
@@ -39,8 +39,9 @@ class FilterConfig
 class DynamicFilterConfig {
   public:
     DynamicFilterConfig() {}
-    DynamicFilterConfig(int8_t w, int16_t qf, int16_t lf, int16_t hf): width(w), q(qf), min_freq(lf), max_freq(hf) {}
+    DynamicFilterConfig(int8_t w, int16_t qf, int16_t lf, int16_t hf, int8_t b = 2): width(w), budget(b), q(qf), min_freq(lf), max_freq(hf) {}
     int8_t width;
+    int8_t budget; // fft work units per axis per update, 0 - whole analysis at once, kept in padding after width
     int16_t q;
     int16_t min_freq;
     int16_t max_freq;
@@ -72,6 +73,7 @@ class FilterStateBiquad {
   public:
     void reset();
     void init(BiquadFilterType filterType, float rate, float freq, float q);
+    void initNotch(float rate, float freq, float q); // table based sin/cos, for frequent retune
     void reconfigure(const FilterStateBiquad& from);
     float update(float n);
     float updateDF1(float n);
@@ -124,6 +126,11 @@ class FilterStatePt3 {
     float v[3];
 };
 
+// group delay in samples at normalized angular frequency omega [rad/sample], for response analysis outside of control loop
+// coefficients as stored by filters, pt: k; biquad: b0 b1 b2 a1 a2; first order: b0 b1 0 a1 0
+// weight blends notch df1 output with input, median is nonlinear and reported as its one sample lag
+float getFilterGroupDelay(FilterType type, const float * c, float weight, float omega);
+
 class Filter
 {
   public:
@@ -141,6 +148,8 @@ class Filter
     void setWeight(float weight);
     float getNotchQApprox(float freq, float cutoff);
     float getNotchQ(float freq, float cutoff);
+    float getGroupDelay(float freq) const; // seconds
+    FilterType type() const { return (FilterType)_conf.type; }
 
 #if !defined(UNIT_TEST)
   private:
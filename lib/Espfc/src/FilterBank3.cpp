@@ -0,0 +1,511 @@
+#include <algorithm>
+#include "FilterBank3.h"
+#include "Math/Utils.h"
+#include "Math/FixedPoint.h"
+#include "Utils/MemoryHelper.h"
+
+namespace Espfc {
+
+FilterBank3::FilterBank3(): _update(&FilterBank3::updateNone), _kernel(&FilterBank3::updateNone), _rate(0), _conf(FilterConfig(FILTER_NONE, 0)), _rampSteps(0), _rampInv(0.f)
+{
+  for(size_t i = 0; i < AXES; i++)
+  {
+    _input_weight[i] = 0.f;
+    _output_weight[i] = 1.f;
+    _rampLeft[i] = 0;
+    _c0[i] = 1.f;
+    _c1[i] = _c2[i] = _c3[i] = _c4[i] = 0.f;
+    _t0[i] = _t1[i] = _t2[i] = _t3[i] = _t4[i] = 0.f;
+    _d0[i] = _d1[i] = _d2[i] = _d3[i] = _d4[i] = 0.f;
+#if defined(ESPFC_FIXED_POINT)
+    for(size_t j = 0; j < COEFS; j++) _kt[j][i] = _kd[j][i] = 0;
+#endif
+    syncFixed(i);
+  }
+  reset();
+}
+
+void FilterBank3::begin()
+{
+  _conf = FilterConfig(FILTER_NONE, 0);
+  selectKernel();
+}
+
+void FilterBank3::begin(const FilterConfig& config, int rate)
+{
+  reconfigure(config, rate);
+  reset();
+}
+
+VectorFloat FAST_CODE_ATTR FilterBank3::update(const VectorFloat& v)
+{
+  VectorFloat r = v;
+  (this->*_update)(r);
+  return r;
+}
+
+void FilterBank3::reset()
+{
+  for(size_t i = 0; i < AXES; i++)
+  {
+    _s0[i] = _s1[i] = _s2[i] = _s3[i] = 0;
+  }
+}
+
+void FilterBank3::setRamp(size_t samples)
+{
+  _rampSteps = samples;
+  _rampInv = samples > 0 ? 1.f / samples : 0.f;
+}
+
+void FAST_CODE_ATTR FilterBank3::reconfigure(int16_t freq, int16_t cutoff)
+{
+  reconfigure(FilterConfig((FilterType)_conf.type, freq, cutoff), _rate);
+}
+
+void FAST_CODE_ATTR FilterBank3::reconfigure(int16_t freq, int16_t cutoff, float q, float weight)
+{
+  reconfigure(FilterConfig((FilterType)_conf.type, freq, cutoff), _rate, q, weight);
+}
+
+void FAST_CODE_ATTR FilterBank3::reconfigure(const FilterConfig& config, int rate)
+{
+  const FilterConfig conf = config.sanitize(rate);
+  switch(conf.type)
+  {
+    case FILTER_BIQUAD:
+      reconfigure(config, rate, 0.70710678118f, 1.0f); // quality factor for butterworth lpf
+      break;
+    case FILTER_NOTCH:
+    case FILTER_NOTCH_DF1:
+    case FILTER_BPF:
+      reconfigure(config, rate, (float)(config.cutoff * config.freq) / ((float)(config.freq - config.cutoff) * (float)(config.freq + config.cutoff)), 1.0f);
+      break;
+    default:
+      reconfigure(config, rate, 0.0f, 1.0f);
+  }
+}
+
+void FAST_CODE_ATTR FilterBank3::reconfigure(const FilterConfig& config, int rate, float q, float weight)
+{
+  _rate = rate;
+  _conf = config.sanitize(_rate);
+  for(size_t i = 0; i < AXES; i++)
+  {
+    init(i, _conf, q, weight);
+  }
+  selectKernel();
+}
+
+void FAST_CODE_ATTR FilterBank3::reconfigureAxis(size_t axis, int16_t freq, int16_t cutoff, float q, float weight)
+{
+  if(!_rampSteps)
+  {
+    init(axis, FilterConfig((FilterType)_conf.type, freq, cutoff).sanitize(_rate), q, weight, true);
+    return;
+  }
+
+#if defined(ESPFC_FIXED_POINT)
+  // compute new coefficients as target, then continue from current integer ones
+  int32_t k[COEFS];
+  for(size_t j = 0; j < COEFS; j++) k[j] = _k[j][axis];
+  init(axis, FilterConfig((FilterType)_conf.type, freq, cutoff).sanitize(_rate), q, weight, true);
+  for(size_t j = 0; j < COEFS; j++)
+  {
+    _kt[j][axis] = _k[j][axis];
+    _kd[j][axis] = (_kt[j][axis] - k[j]) / (int32_t)_rampSteps;
+    _k[j][axis] = k[j];
+  }
+#else
+  // compute new coefficients as target, then continue from current ones
+  const float c0 = _c0[axis], c1 = _c1[axis], c2 = _c2[axis], c3 = _c3[axis], c4 = _c4[axis];
+  init(axis, FilterConfig((FilterType)_conf.type, freq, cutoff).sanitize(_rate), q, weight, true);
+  _t0[axis] = _c0[axis]; _d0[axis] = (_t0[axis] - c0) * _rampInv; _c0[axis] = c0;
+  _t1[axis] = _c1[axis]; _d1[axis] = (_t1[axis] - c1) * _rampInv; _c1[axis] = c1;
+  _t2[axis] = _c2[axis]; _d2[axis] = (_t2[axis] - c2) * _rampInv; _c2[axis] = c2;
+  _t3[axis] = _c3[axis]; _d3[axis] = (_t3[axis] - c3) * _rampInv; _c3[axis] = c3;
+  _t4[axis] = _c4[axis]; _d4[axis] = (_t4[axis] - c4) * _rampInv; _c4[axis] = c4;
+#endif
+  _rampLeft[axis] = _rampSteps;
+  _update = &FilterBank3::updateRamp;
+}
+
+void FAST_CODE_ATTR FilterBank3::copyCoefs(size_t from)
+{
+  for(size_t i = 0; i < AXES; i++)
+  {
+    if(i == from) continue;
+    _c0[i] = _c0[from];
+    _c1[i] = _c1[from];
+    _c2[i] = _c2[from];
+    _c3[i] = _c3[from];
+    _c4[i] = _c4[from];
+    _input_weight[i] = _input_weight[from];
+    _output_weight[i] = _output_weight[from];
+    _rampLeft[i] = _rampLeft[from];
+    _t0[i] = _t0[from]; _t1[i] = _t1[from]; _t2[i] = _t2[from]; _t3[i] = _t3[from]; _t4[i] = _t4[from];
+    _d0[i] = _d0[from]; _d1[i] = _d1[from]; _d2[i] = _d2[from]; _d3[i] = _d3[from]; _d4[i] = _d4[from];
+#if defined(ESPFC_FIXED_POINT)
+    for(size_t j = 0; j < COEFS; j++)
+    {
+      _k[j][i] = _k[j][from];
+      _kt[j][i] = _kt[j][from];
+      _kd[j][i] = _kd[j][from];
+    }
+    _ki[i] = _ki[from];
+    _ko[i] = _ko[from];
+#endif
+  }
+}
+
+float FilterBank3::getGroupDelay(float freq, size_t axis) const
+{
+  if(_conf.type == FILTER_NONE || _rate <= 0 || axis >= AXES) return 0.f;
+  // while ramping, response of coefficients currently applied
+  const float c[5] = { _c0[axis], _c1[axis], _c2[axis], _c3[axis], _c4[axis] };
+  return getFilterGroupDelay((FilterType)_conf.type, c, _output_weight[axis], 2.f * Math::pi() * freq / _rate) / _rate;
+}
+
+void FAST_CODE_ATTR FilterBank3::init(size_t axis, const FilterConfig& conf, float q, float weight, bool fast)
+{
+  _output_weight[axis] = std::max(0.0f, std::min(weight, 1.0f));
+  _input_weight[axis] = 1.0f - _output_weight[axis];
+
+  // pass through, if this axis is turned off, but bank type is not
+  _c0[axis] = 1.f;
+  _c1[axis] = _c2[axis] = _c3[axis] = _c4[axis] = 0.f;
+  if(conf.type == FILTER_NONE)
+  {
+    syncFixed(axis);
+    return;
+  }
+
+  switch(_conf.type)
+  {
+    case FILTER_PT1:
+    {
+      FilterStatePt1 s;
+      s.init(_rate, conf.freq);
+      _c0[axis] = s.k;
+      break;
+    }
+    case FILTER_PT2:
+    {
+      FilterStatePt2 s;
+      s.init(_rate, conf.freq);
+      _c0[axis] = s.k;
+      break;
+    }
+    case FILTER_PT3:
+    {
+      FilterStatePt3 s;
+      s.init(_rate, conf.freq);
+      _c0[axis] = s.k;
+      break;
+    }
+    case FILTER_BIQUAD:
+    case FILTER_NOTCH:
+    case FILTER_NOTCH_DF1:
+    case FILTER_BPF:
+    {
+      const BiquadFilterType bqType = _conf.type == FILTER_BIQUAD ? BIQUAD_FILTER_LPF : (_conf.type == FILTER_BPF ? BIQUAD_FILTER_BPF : BIQUAD_FILTER_NOTCH);
+      FilterStateBiquad s;
+      if(fast && bqType == BIQUAD_FILTER_NOTCH) s.initNotch(_rate, conf.freq, q);
+      else s.init(bqType, _rate, conf.freq, q);
+      _c0[axis] = s.b0;
+      _c1[axis] = s.b1;
+      _c2[axis] = s.b2;
+      _c3[axis] = s.a1;
+      _c4[axis] = s.a2;
+      break;
+    }
+    case FILTER_FO:
+    {
+      FilterStateFirstOrder s;
+      s.init(_rate, conf.freq);
+      _c0[axis] = s.b0;
+      _c1[axis] = s.b1;
+      _c3[axis] = s.a1;
+      break;
+    }
+    default:
+      break;
+  }
+  syncFixed(axis);
+}
+
+void FAST_CODE_ATTR FilterBank3::syncFixed(size_t axis)
+{
+#if defined(ESPFC_FIXED_POINT)
+  // pt gain is in [0, 1], so it gets one more bit
+  const bool pt = _conf.type == FILTER_PT1 || _conf.type == FILTER_PT2 || _conf.type == FILTER_PT3;
+  _k[0][axis] = pt ? Math::toQ31(_c0[axis]) : Math::toQ30(_c0[axis]);
+  _k[1][axis] = Math::toQ30(_c1[axis]);
+  _k[2][axis] = Math::toQ30(_c2[axis]);
+  _k[3][axis] = Math::toQ30(_c3[axis]);
+  _k[4][axis] = Math::toQ30(_c4[axis]);
+  _ko[axis] = Math::toQ30(_output_weight[axis]);
+  _ki[axis] = Math::toQ30(1.f) - _ko[axis];
+#else
+  (void)axis;
+#endif
+}
+
+void FilterBank3::selectKernel()
+{
+  switch(_conf.type)
+  {
+    case FILTER_PT1:
+      _kernel = &FilterBank3::updatePt1;
+      break;
+    case FILTER_PT2:
+      _kernel = &FilterBank3::updatePt2;
+      break;
+    case FILTER_PT3:
+      _kernel = &FilterBank3::updatePt3;
+      break;
+    case FILTER_BIQUAD:
+    case FILTER_NOTCH:
+    case FILTER_BPF:
+      _kernel = &FilterBank3::updateBiquad;
+      break;
+    case FILTER_NOTCH_DF1:
+      _kernel = &FilterBank3::updateBiquadDF1;
+      break;
+    case FILTER_FO:
+      _kernel = &FilterBank3::updateFirstOrder;
+      break;
+    case FILTER_FIR2:
+      _kernel = &FilterBank3::updateFir2;
+      break;
+    case FILTER_MEDIAN3:
+      _kernel = &FilterBank3::updateMedian3;
+      break;
+    case FILTER_NONE:
+    default:
+      _kernel = &FilterBank3::updateNone;
+  }
+
+  // full reconfigure cancels pending crossfade
+  for(size_t i = 0; i < AXES; i++)
+  {
+    _rampLeft[i] = 0;
+  }
+  _update = _kernel;
+}
+
+// axes are written out explicitly, so independent axes interleave and stay in registers
+#if defined(ESPFC_FIXED_POINT)
+#define FILTER_BANK3_APPLY(fn, v) { \
+  v.x = Math::fromQ16(fn(0, Math::toQ16(v.x))); \
+  v.y = Math::fromQ16(fn(1, Math::toQ16(v.y))); \
+  v.z = Math::fromQ16(fn(2, Math::toQ16(v.z))); }
+#else
+#define FILTER_BANK3_APPLY(fn, v) { v.x = fn(0, v.x); v.y = fn(1, v.y); v.z = fn(2, v.z); }
+#endif
+
+void FAST_CODE_ATTR FilterBank3::updateRamp(VectorFloat& v)
+{
+  bool active = false;
+  for(size_t i = 0; i < AXES; i++)
+  {
+    if(!_rampLeft[i]) continue;
+#if defined(ESPFC_FIXED_POINT)
+    if(--_rampLeft[i] == 0)
+    {
+      // land exactly on target, no accumulated rounding
+      for(size_t j = 0; j < COEFS; j++) _k[j][i] = _kt[j][i];
+      continue;
+    }
+    for(size_t j = 0; j < COEFS; j++) _k[j][i] += _kd[j][i];
+#else
+    if(--_rampLeft[i] == 0)
+    {
+      // land exactly on target, no accumulated rounding
+      _c0[i] = _t0[i]; _c1[i] = _t1[i]; _c2[i] = _t2[i]; _c3[i] = _t3[i]; _c4[i] = _t4[i];
+      continue;
+    }
+    _c0[i] += _d0[i]; _c1[i] += _d1[i]; _c2[i] += _d2[i]; _c3[i] += _d3[i]; _c4[i] += _d4[i];
+#endif
+    active = true;
+  }
+  if(!active) _update = _kernel;
+  (this->*_kernel)(v);
+}
+
+void FAST_CODE_ATTR FilterBank3::updateNone(VectorFloat& v)
+{
+}
+
+void FAST_CODE_ATTR FilterBank3::updatePt1(VectorFloat& v)
+{
+  FILTER_BANK3_APPLY(pt1, v);
+}
+
+void FAST_CODE_ATTR FilterBank3::updatePt2(VectorFloat& v)
+{
+  FILTER_BANK3_APPLY(pt2, v);
+}
+
+void FAST_CODE_ATTR FilterBank3::updatePt3(VectorFloat& v)
+{
+  FILTER_BANK3_APPLY(pt3, v);
+}
+
+void FAST_CODE_ATTR FilterBank3::updateBiquad(VectorFloat& v)
+{
+  FILTER_BANK3_APPLY(biquad, v);
+}
+
+void FAST_CODE_ATTR FilterBank3::updateBiquadDF1(VectorFloat& v)
+{
+  FILTER_BANK3_APPLY(biquadDF1, v);
+}
+
+void FAST_CODE_ATTR FilterBank3::updateFirstOrder(VectorFloat& v)
+{
+  FILTER_BANK3_APPLY(firstOrder, v);
+}
+
+void FAST_CODE_ATTR FilterBank3::updateFir2(VectorFloat& v)
+{
+  FILTER_BANK3_APPLY(fir2, v);
+}
+
+void FAST_CODE_ATTR FilterBank3::updateMedian3(VectorFloat& v)
+{
+  FILTER_BANK3_APPLY(median3, v);
+}
+
+#if defined(ESPFC_FIXED_POINT)
+
+FilterBank3::Sample FilterBank3::pt1(size_t i, Sample n)
+{
+  _s0[i] += Math::mulQ31(n - _s0[i], _k[0][i]);
+  return _s0[i];
+}
+
+FilterBank3::Sample FilterBank3::pt2(size_t i, Sample n)
+{
+  _s0[i] += Math::mulQ31(n - _s0[i], _k[0][i]);
+  _s1[i] += Math::mulQ31(_s0[i] - _s1[i], _k[0][i]);
+  return _s1[i];
+}
+
+FilterBank3::Sample FilterBank3::pt3(size_t i, Sample n)
+{
+  _s0[i] += Math::mulQ31(n - _s0[i], _k[0][i]);
+  _s1[i] += Math::mulQ31(_s0[i] - _s1[i], _k[0][i]);
+  _s2[i] += Math::mulQ31(_s1[i] - _s2[i], _k[0][i]);
+  return _s2[i];
+}
+
+FilterBank3::Sample FilterBank3::biquad(size_t i, Sample n)
+{
+  // DF2
+  const int32_t r = Math::mulQ30(n, _k[0][i]) + _s0[i];
+  _s0[i] = Math::roundFixed<Math::Q30_BITS>((int64_t)n * _k[1][i] - (int64_t)r * _k[3][i]) + _s1[i];
+  _s1[i] = Math::roundFixed<Math::Q30_BITS>((int64_t)n * _k[2][i] - (int64_t)r * _k[4][i]);
+  return r;
+}
+
+FilterBank3::Sample FilterBank3::biquadDF1(size_t i, Sample n)
+{
+  // single rounding of whole sum
+  const int32_t r = Math::roundFixed<Math::Q30_BITS>((int64_t)n * _k[0][i] + (int64_t)_s0[i] * _k[1][i] + (int64_t)_s1[i] * _k[2][i] - (int64_t)_s2[i] * _k[3][i] - (int64_t)_s3[i] * _k[4][i]);
+  _s1[i] = _s0[i]; _s0[i] = n;
+  _s3[i] = _s2[i]; _s2[i] = r;
+  return Math::roundFixed<Math::Q30_BITS>((int64_t)r * _ko[i] + (int64_t)n * _ki[i]);
+}
+
+FilterBank3::Sample FilterBank3::firstOrder(size_t i, Sample n)
+{
+  // DF2
+  const int32_t r = Math::mulQ30(n, _k[0][i]) + _s0[i];
+  _s0[i] = Math::roundFixed<Math::Q30_BITS>((int64_t)n * _k[1][i] - (int64_t)r * _k[3][i]);
+  return r;
+}
+
+FilterBank3::Sample FilterBank3::fir2(size_t i, Sample n)
+{
+  _s0[i] = (int32_t)(((int64_t)n + _s1[i]) >> 1);
+  _s1[i] = n;
+  return _s0[i];
+}
+
+FilterBank3::Sample FilterBank3::median3(size_t i, Sample n)
+{
+  _s0[i] = _s1[i];
+  _s1[i] = _s2[i];
+  _s2[i] = n;
+  // median of three without sorting
+  return std::max(std::min(_s0[i], _s1[i]), std::min(std::max(_s0[i], _s1[i]), _s2[i]));
+}
+
+#else
+
+FilterBank3::Sample FilterBank3::pt1(size_t i, Sample n)
+{
+  _s0[i] += _c0[i] * (n - _s0[i]);
+  return _s0[i];
+}
+
+FilterBank3::Sample FilterBank3::pt2(size_t i, Sample n)
+{
+  _s0[i] += _c0[i] * (n - _s0[i]);
+  _s1[i] += _c0[i] * (_s0[i] - _s1[i]);
+  return _s1[i];
+}
+
+FilterBank3::Sample FilterBank3::pt3(size_t i, Sample n)
+{
+  _s0[i] += _c0[i] * (n - _s0[i]);
+  _s1[i] += _c0[i] * (_s0[i] - _s1[i]);
+  _s2[i] += _c0[i] * (_s1[i] - _s2[i]);
+  return _s2[i];
+}
+
+FilterBank3::Sample FilterBank3::biquad(size_t i, Sample n)
+{
+  // DF2
+  const float r = _c0[i] * n + _s0[i];
+  _s0[i] = _c1[i] * n - _c3[i] * r + _s1[i];
+  _s1[i] = _c2[i] * n - _c4[i] * r;
+  return r;
+}
+
+FilterBank3::Sample FilterBank3::biquadDF1(size_t i, Sample n)
+{
+  const float r = _c0[i] * n + _c1[i] * _s0[i] + _c2[i] * _s1[i] - _c3[i] * _s2[i] - _c4[i] * _s3[i];
+  _s1[i] = _s0[i]; _s0[i] = n;
+  _s3[i] = _s2[i]; _s2[i] = r;
+  return _output_weight[i] * r + _input_weight[i] * n;
+}
+
+FilterBank3::Sample FilterBank3::firstOrder(size_t i, Sample n)
+{
+  // DF2
+  const float r = _c0[i] * n + _s0[i];
+  _s0[i] = _c1[i] * n - _c3[i] * r;
+  return r;
+}
+
+FilterBank3::Sample FilterBank3::fir2(size_t i, Sample n)
+{
+  _s0[i] = (n + _s1[i]) * 0.5f;
+  _s1[i] = n;
+  return _s0[i];
+}
+
+FilterBank3::Sample FilterBank3::median3(size_t i, Sample n)
+{
+  _s0[i] = _s1[i];
+  _s1[i] = _s2[i];
+  _s2[i] = n;
+  // median of three without sorting
+  return std::max(std::min(_s0[i], _s1[i]), std::min(std::max(_s0[i], _s1[i]), _s2[i]));
+}
+
+#endif
+
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <helper_3dmath.h>
+#include "Filter.h"
+
+namespace Espfc {
+
+/**
+ * Three axis filter with coefficients and state stored side by side.
+ * Filter kernel is selected once in begin()/reconfigure(), update() processes all axes in one pass.
+ * All axes share filter type, but may have different coefficients.
+ * Single axis retune may crossfade coefficients over a few samples, see setRamp().
+ * With ESPFC_FIXED_POINT kernels are integer, samples are converted to Q16.16 once per bank, state is kept in Q16.16
+ * and float coefficients are mirrored to Q30 (Q31 for pt gain) whenever they change, see Math/FixedPoint.h.
+ */
+class FilterBank3
+{
+  public:
+    static constexpr size_t AXES = 3;
+
+    FilterBank3();
+    void begin();
+    void begin(const FilterConfig& config, int rate);
+    VectorFloat update(const VectorFloat& v);
+    void reset();
+    // crossfade length for reconfigureAxis() in samples, 0 switches coefficients immediately
+    void setRamp(size_t samples);
+
+    // reconfigure all axes
+    void reconfigure(int16_t freq, int16_t cutoff = 0);
+    void reconfigure(int16_t freq, int16_t cutoff, float q, float weight = 1.0f);
+    void reconfigure(const FilterConfig& config, int rate);
+    void reconfigure(const FilterConfig& config, int rate, float q, float weight);
+
+    // reconfigure single axis, keeps filter type, notch coefficients use table based sin/cos
+    void reconfigureAxis(size_t axis, int16_t freq, int16_t cutoff, float q, float weight = 1.0f);
+    // copy coefficients from one axis to others
+    void copyCoefs(size_t from);
+
+    FilterType type() const { return (FilterType)_conf.type; }
+    float getGroupDelay(float freq, size_t axis = 0) const; // seconds
+
+  private:
+    typedef void (FilterBank3::*UpdateFn)(VectorFloat& v);
+
+    void init(size_t axis, const FilterConfig& config, float q, float weight, bool fast = false);
+    void selectKernel();
+    void syncFixed(size_t axis);
+
+#if defined(ESPFC_FIXED_POINT)
+    typedef int32_t Sample;
+#else
+    typedef float Sample;
+#endif
+
+    void updateRamp(VectorFloat& v);
+    void updateNone(VectorFloat& v);
+    void updatePt1(VectorFloat& v);
+    void updatePt2(VectorFloat& v);
+    void updatePt3(VectorFloat& v);
+    void updateBiquad(VectorFloat& v);
+    void updateBiquadDF1(VectorFloat& v);
+    void updateFirstOrder(VectorFloat& v);
+    void updateFir2(VectorFloat& v);
+    void updateMedian3(VectorFloat& v);
+
+    inline Sample pt1(size_t i, Sample n);
+    inline Sample pt2(size_t i, Sample n);
+    inline Sample pt3(size_t i, Sample n);
+    inline Sample biquad(size_t i, Sample n);
+    inline Sample biquadDF1(size_t i, Sample n);
+    inline Sample firstOrder(size_t i, Sample n);
+    inline Sample fir2(size_t i, Sample n);
+    inline Sample median3(size_t i, Sample n);
+
+    UpdateFn _update;
+    UpdateFn _kernel;
+    int _rate;
+    FilterConfig _conf;
+
+    // coefficients, pt: k = c0; biquad: b0 b1 b2 a1 a2; first order: b0 b1 a1
+    float _c0[AXES], _c1[AXES], _c2[AXES], _c3[AXES], _c4[AXES];
+    // state, pt: v0 v1 v2; biquad DF2: x1 x2; biquad DF1: x1 x2 y1 y2; fir2/median: history
+    Sample _s0[AXES], _s1[AXES], _s2[AXES], _s3[AXES];
+    float _input_weight[AXES];
+    float _output_weight[AXES];
+#if defined(ESPFC_FIXED_POINT)
+    // integer copies of coefficients and weights used by kernels, crossfade runs on them,
+    // float coefficients jump to target, so group delay reports target response while ramping
+    static constexpr size_t COEFS = 5;
+    int32_t _k[COEFS][AXES];
+    int32_t _kt[COEFS][AXES];
+    int32_t _kd[COEFS][AXES];
+    int32_t _ki[AXES], _ko[AXES];
+#endif
+
+    // coefficient crossfade, targets and per sample steps
+    size_t _rampSteps;
+    float _rampInv;
+    size_t _rampLeft[AXES];
+    float _t0[AXES], _t1[AXES], _t2[AXES], _t3[AXES], _t4[AXES];
+    float _d0[AXES], _d1[AXES], _d2[AXES], _d3[AXES], _d4[AXES];
+};
+
+}
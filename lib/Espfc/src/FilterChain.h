@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+namespace Espfc {
+
+/**
+ * Compile time chain of filter stages, calls are expanded inline in stage order.
+ * Stage is a type with static void apply(Context&, Sample&).
+ */
+template<typename Context, typename Sample, typename... Stages>
+struct FilterChain;
+
+template<typename Context, typename Sample>
+struct FilterChain<Context, Sample>
+{
+  static inline void apply(Context& ctx, Sample& v) {}
+};
+
+template<typename Context, typename Sample, typename Stage, typename... Rest>
+struct FilterChain<Context, Sample, Stage, Rest...>
+{
+  static inline void apply(Context& ctx, Sample& v)
+  {
+    Stage::apply(ctx, v);
+    FilterChain<Context, Sample, Rest...>::apply(ctx, v);
+  }
+};
+
+/**
+ * Optional stage, removed from chain at compile time when not enabled.
+ */
+template<bool enabled, typename Stage>
+struct FilterStageIf
+{
+  template<typename Context, typename Sample>
+  static inline void apply(Context& ctx, Sample& v)
+  {
+    Stage::apply(ctx, v);
+  }
+};
+
+template<typename Stage>
+struct FilterStageIf<false, Stage>
+{
+  template<typename Context, typename Sample>
+  static inline void apply(Context& ctx, Sample& v) {}
+};
+
+/**
+ * Table of chain specializations, one per combination of optional stages.
+ * Chain<mask> must provide static apply(Context&, Sample&), mask bit n enables optional stage n.
+ */
+template<typename Context, typename Sample, template<size_t> class Chain, size_t optionalStages>
+class FilterChainSelector
+{
+  public:
+    typedef void (*ApplyFn)(Context&, Sample&);
+    static constexpr size_t COUNT = 1u << optionalStages;
+
+    static ApplyFn select(size_t mask)
+    {
+      return table(std::make_index_sequence<COUNT>())[mask & (COUNT - 1)];
+    }
+
+  private:
+    template<size_t... masks>
+    static const ApplyFn * table(std::index_sequence<masks...>)
+    {
+      static const ApplyFn fns[] = { &Chain<masks>::apply... };
+      return fns;
+    }
+};
+
+}
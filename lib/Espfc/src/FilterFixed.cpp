@@ -0,0 +1,198 @@
+#include <algorithm>
+#include "FilterFixed.h"
+#include "Math/FixedPoint.h"
+#include "Math/Utils.h"
+#include "Utils/MemoryHelper.h"
+
+namespace Espfc {
+
+FilterFixed::FilterFixed(): _rate(0), _conf(FilterConfig(FILTER_NONE, 0)), _input_weight(0), _output_weight(Math::toQ30(1.f))
+{
+  std::fill_n(_c, 5, 0);
+  reset();
+}
+
+void FilterFixed::begin()
+{
+  _conf = FilterConfig(FILTER_NONE, 0);
+}
+
+void FilterFixed::begin(const FilterConfig& config, int rate)
+{
+  reconfigure(config, rate);
+  reset();
+}
+
+float FAST_CODE_ATTR FilterFixed::update(float v)
+{
+  if(_conf.type == FILTER_NONE) return v;
+  return Math::fromQ16(updateFixed(Math::toQ16(v)));
+}
+
+int32_t FAST_CODE_ATTR FilterFixed::updateFixed(int32_t n)
+{
+  switch(_conf.type)
+  {
+    case FILTER_PT3:
+      _s[0] += Math::mulQ31(n - _s[0], _c[0]);
+      _s[1] += Math::mulQ31(_s[0] - _s[1], _c[0]);
+      _s[2] += Math::mulQ31(_s[1] - _s[2], _c[0]);
+      return _s[2];
+    case FILTER_PT2:
+      _s[0] += Math::mulQ31(n - _s[0], _c[0]);
+      _s[1] += Math::mulQ31(_s[0] - _s[1], _c[0]);
+      return _s[1];
+    case FILTER_PT1:
+      _s[0] += Math::mulQ31(n - _s[0], _c[0]);
+      return _s[0];
+    case FILTER_BIQUAD:
+    case FILTER_NOTCH:
+    case FILTER_BPF:
+    {
+      // DF2 transposed
+      const int32_t r = Math::mulQ30(n, _c[0]) + _s[0];
+      _s[0] = Math::roundFixed<Math::Q30_BITS>((int64_t)n * _c[1] - (int64_t)r * _c[3]) + _s[1];
+      _s[1] = Math::roundFixed<Math::Q30_BITS>((int64_t)n * _c[2] - (int64_t)r * _c[4]);
+      return r;
+    }
+    case FILTER_NOTCH_DF1:
+    {
+      // single rounding of whole sum
+      const int32_t r = Math::roundFixed<Math::Q30_BITS>((int64_t)n * _c[0] + (int64_t)_s[0] * _c[1] + (int64_t)_s[1] * _c[2] - (int64_t)_s[2] * _c[3] - (int64_t)_s[3] * _c[4]);
+      _s[1] = _s[0]; _s[0] = n;
+      _s[3] = _s[2]; _s[2] = r;
+      return Math::roundFixed<Math::Q30_BITS>((int64_t)r * _output_weight + (int64_t)n * _input_weight);
+    }
+    case FILTER_FO:
+    {
+      const int32_t r = Math::mulQ30(n, _c[0]) + _s[0];
+      _s[0] = Math::roundFixed<Math::Q30_BITS>((int64_t)n * _c[1] - (int64_t)r * _c[3]);
+      return r;
+    }
+    case FILTER_FIR2:
+      _s[0] = (int32_t)(((int64_t)n + _s[1]) >> 1);
+      _s[1] = n;
+      return _s[0];
+    case FILTER_MEDIAN3:
+      _s[0] = _s[1];
+      _s[1] = _s[2];
+      _s[2] = n;
+      return std::max(std::min(_s[0], _s[1]), std::min(std::max(_s[0], _s[1]), _s[2]));
+    case FILTER_NONE:
+    default:
+      return n;
+  }
+}
+
+void FilterFixed::reset()
+{
+  std::fill_n(_s, 4, 0);
+}
+
+void FAST_CODE_ATTR FilterFixed::reconfigure(int16_t freq, int16_t cutoff)
+{
+  reconfigure(FilterConfig((FilterType)_conf.type, freq, cutoff), _rate);
+}
+
+void FAST_CODE_ATTR FilterFixed::reconfigure(int16_t freq, int16_t cutoff, float q, float weight)
+{
+  reconfigure(FilterConfig((FilterType)_conf.type, freq, cutoff), _rate, q, weight);
+}
+
+void FAST_CODE_ATTR FilterFixed::reconfigure(const FilterConfig& config, int rate)
+{
+  const FilterConfig conf = config.sanitize(rate);
+  switch(conf.type)
+  {
+    case FILTER_BIQUAD:
+      reconfigure(config, rate, 0.70710678118f, 1.0f); // quality factor for butterworth lpf
+      break;
+    case FILTER_NOTCH:
+    case FILTER_NOTCH_DF1:
+    case FILTER_BPF:
+      reconfigure(config, rate, (float)(config.cutoff * config.freq) / ((float)(config.freq - config.cutoff) * (float)(config.freq + config.cutoff)), 1.0f);
+      break;
+    default:
+      reconfigure(config, rate, 0.0f, 1.0f);
+  }
+}
+
+void FAST_CODE_ATTR FilterFixed::reconfigure(const FilterConfig& config, int rate, float q, float weight)
+{
+  _rate = rate;
+  _conf = config.sanitize(_rate);
+  setWeight(weight);
+  switch(_conf.type)
+  {
+    case FILTER_PT1:
+    {
+      FilterStatePt1 s;
+      s.init(_rate, _conf.freq);
+      _c[0] = Math::toQ31(s.k);
+      break;
+    }
+    case FILTER_PT2:
+    {
+      FilterStatePt2 s;
+      s.init(_rate, _conf.freq);
+      _c[0] = Math::toQ31(s.k);
+      break;
+    }
+    case FILTER_PT3:
+    {
+      FilterStatePt3 s;
+      s.init(_rate, _conf.freq);
+      _c[0] = Math::toQ31(s.k);
+      break;
+    }
+    case FILTER_BIQUAD:
+    case FILTER_NOTCH:
+    case FILTER_NOTCH_DF1:
+    case FILTER_BPF:
+    {
+      const BiquadFilterType bqType = _conf.type == FILTER_BIQUAD ? BIQUAD_FILTER_LPF : (_conf.type == FILTER_BPF ? BIQUAD_FILTER_BPF : BIQUAD_FILTER_NOTCH);
+      FilterStateBiquad s;
+      s.init(bqType, _rate, _conf.freq, q);
+      _c[0] = Math::toQ30(s.b0);
+      _c[1] = Math::toQ30(s.b1);
+      _c[2] = Math::toQ30(s.b2);
+      _c[3] = Math::toQ30(s.a1);
+      _c[4] = Math::toQ30(s.a2);
+      break;
+    }
+    case FILTER_FO:
+    {
+      FilterStateFirstOrder s;
+      s.init(_rate, _conf.freq);
+      _c[0] = Math::toQ30(s.b0);
+      _c[1] = Math::toQ30(s.b1);
+      _c[3] = Math::toQ30(s.a1);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void FAST_CODE_ATTR FilterFixed::setWeight(float weight)
+{
+  const float w = std::max(0.0f, std::min(weight, 1.0f));
+  _output_weight = Math::toQ30(w);
+  _input_weight = Math::toQ30(1.0f) - _output_weight;
+}
+
+float FilterFixed::getGroupDelay(float freq) const
+{
+  if(_conf.type == FILTER_NONE || _rate <= 0) return 0.f;
+  float c[5];
+  const bool pt = _conf.type == FILTER_PT1 || _conf.type == FILTER_PT2 || _conf.type == FILTER_PT3;
+  for(size_t i = 0; i < 5; i++)
+  {
+    c[i] = pt ? Math::fromFixed<Math::Q31_BITS>(_c[i]) : Math::fromFixed<Math::Q30_BITS>(_c[i]);
+  }
+  if(_conf.type == FILTER_FO) c[2] = c[4] = 0.f; // not used by first order, may hold previous biquad
+  const float weight = Math::fromFixed<Math::Q30_BITS>(_output_weight);
+  return getFilterGroupDelay((FilterType)_conf.type, c, weight, 2.f * Math::pi() * freq / _rate) / _rate;
+}
+
+}
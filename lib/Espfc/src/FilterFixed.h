@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include "Filter.h"
+
+namespace Espfc {
+
+/**
+ * Integer implementation of Filter for targets without FPU.
+ * Samples are Q16.16 (see Math/FixedPoint.h), so input must stay within +/-32768.
+ * Coefficients are computed in float on reconfigure only, update path is integer.
+ */
+class FilterFixed
+{
+  public:
+    FilterFixed();
+    void begin();
+    void begin(const FilterConfig& config, int rate);
+    float update(float v);
+    int32_t updateFixed(int32_t v);
+    void reset();
+
+    void reconfigure(int16_t freq, int16_t cutoff = 0);
+    void reconfigure(int16_t freq, int16_t cutoff, float q, float weight = 1.0f);
+    void reconfigure(const FilterConfig& config, int rate);
+    void reconfigure(const FilterConfig& config, int rate, float q, float weight);
+    void setWeight(float weight);
+
+    FilterType type() const { return (FilterType)_conf.type; }
+    float getGroupDelay(float freq) const; // seconds
+
+  private:
+    int _rate;
+    FilterConfig _conf;
+
+    // pt: k [q31]; biquad: b0 b1 b2 a1 a2 [q30]; first order: b0 b1 a1 [q30]
+    int32_t _c[5];
+    // pt: v0 v1 v2; biquad DF2: x1 x2; biquad DF1: x1 x2 y1 y2; fir2/median: history [q16]
+    int32_t _s[4];
+    int32_t _input_weight;  // q30
+    int32_t _output_weight; // q30
+};
+
+}
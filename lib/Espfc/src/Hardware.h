@@ -16,6 +16,9 @@
 #include "Device/BusSPI.h"
 #endif
 #include "Device/BusSlave.h"
+#if defined(ESPFC_SITL)
+#include "Device/BusSitl.h"
+#endif
 #include "Device/GyroDevice.h"
 #include "Device/GyroMPU6050.h"
 #include "Device/GyroMPU6500.h"
@@ -43,6 +46,9 @@ namespace {
 #endif
 #if defined(ESPFC_I2C_0)
   static Espfc::Device::BusI2C i2cBus(WireInstance);
+#endif
+#if defined(ESPFC_SITL)
+  static Espfc::Device::BusSitl sitlBus;
 #endif
   static Espfc::Device::BusSlave gyroSlaveBus;
   static Espfc::Device::GyroMPU6050 mpu6050;
@@ -123,6 +129,9 @@ class Hardware
         if(!detectedGyro && detectDevice(lsm6dso, i2cBus)) detectedGyro = &lsm6dso;
         if(detectedGyro) gyroSlaveBus.begin(&i2cBus, detectedGyro->getAddress());
       }
+#endif
+#if defined(ESPFC_SITL)
+      if(!detectedGyro && detectDevice(mpu6500, sitlBus)) detectedGyro = &mpu6500;
 #endif
       if(!detectedGyro) return;
 
@@ -214,6 +223,17 @@ class Hardware
     }
 #endif
 
+#if defined(ESPFC_SITL)
+    template<typename Dev>
+    bool detectDevice(Dev& dev, Device::BusSitl& bus)
+    {
+      typename Dev::DeviceType type = dev.getType();
+      bool status = dev.begin(&bus);
+      _model.logger.info().log(F("SIM DETECT")).log(FPSTR(Dev::getName(type))).logln(status ? "Y" : "");
+      return status;
+    }
+#endif
+
     template<typename Dev>
     bool detectDevice(Dev& dev, Device::BusSlave& bus)
     {
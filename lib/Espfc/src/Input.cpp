@@ -40,6 +40,7 @@ int Input::begin()
     _model.state.inputBufferPrevious[c] = v;
     setInput((Axis)c, v, true, true);
   }
+  publish();
   return 1;
 }
 
@@ -88,6 +89,8 @@ int FAST_CODE_ATTR Input::update()
     filterInputs(status);
   }
 
+  publish();
+
   if(_model.config.debugMode == DEBUG_PIDLOOP)
   {
     _model.state.debug[1] = micros() - startTime;
@@ -96,6 +99,19 @@ int FAST_CODE_ATTR Input::update()
   return 1;
 }
 
+void FAST_CODE_ATTR Input::publish()
+{
+  InputSnapshot snapshot;
+  std::copy_n(_model.state.input, INPUT_CHANNELS, snapshot.input);
+  std::copy_n(_model.state.inputUs, INPUT_CHANNELS, snapshot.inputUs);
+#if defined(ESPFC_MULTI_CORE)
+  // inputSampled belongs to pid task, it takes coherent copy in Controller::update()
+  _model.state.inputSample.write(snapshot);
+#else
+  _model.state.inputSampled = snapshot;
+#endif
+}
+
 InputStatus FAST_CODE_ATTR Input::readInputs()
 {
   Stats::Measure readMeasure(_model.state.stats, COUNTER_INPUT_READ);
@@ -365,6 +381,14 @@ Device::InputDevice * Input::getInputDevice()
     _model.logger.info().log(F("RX ESPNOW")).logln(status);
     return &_espnow;
   }
+#endif
+#if defined(ESPFC_SITL)
+  else
+  {
+    _sitl.begin();
+    _model.logger.info().logln(F("RX SITL"));
+    return &_sitl;
+  }
 #endif
   return nullptr;
 }
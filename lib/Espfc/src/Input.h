@@ -9,6 +9,9 @@
 #if defined(ESPFC_ESPNOW)
 #include "Device/InputEspNow.h"
 #endif
+#if defined(ESPFC_SITL)
+#include "Device/InputSitl.h"
+#endif
 
 namespace Espfc {
 
@@ -46,6 +49,7 @@ class Input
     void filterInputs(InputStatus status);
 
     void updateFrameRate();
+    void publish();
     Device::InputDevice * getInputDevice();
 
   private:
@@ -64,6 +68,9 @@ class Input
 #if defined(ESPFC_ESPNOW)
     Device::InputEspNow _espnow;
 #endif
+#if defined(ESPFC_SITL)
+    Device::InputSitl _sitl;
+#endif
 
     static const uint32_t TENTH_TO_US = 100000UL;  // 1_000_000 / 10;
     static const uint32_t FRAME_TIME_DEFAULT_US = 23000; // 23 ms
@@ -5,8 +5,12 @@
 
 #include "Math/Utils.h"
 #include "Filter.h"
+#if defined(ESPFC_DSP)
 #include "dsps_fft4r.h"
 #include "dsps_wind_hann.h"
+#else
+#include "Math/FFTReal.h"
+#endif
 #include <algorithm>
 
 namespace Espfc {
@@ -15,15 +19,23 @@ namespace Math {
 
 enum FFTPhase {
   PHASE_COLLECT,
+  PHASE_WINDOW,
   PHASE_FFT,
-  PHASE_PEAKS
+  PHASE_MAGNITUDE,
+  PHASE_PEAKS,
+  PHASE_PUBLISH,
 };
 
+/**
+ * Analysis is split into work units: window chunk, fft stage, magnitude chunk, peak search chunk and publish.
+ * Magnitude is computed only for bins within min_freq..max_freq range.
+ * Each update() runs at most budget units, so analysis is spread over several samples.
+ */
 template<size_t SAMPLES>
 class FFTAnalyzer
 {
 public:
-  FFTAnalyzer(): _idx(0), _phase(PHASE_COLLECT) {}
+  FFTAnalyzer(): _idx(0), _phase(PHASE_COLLECT), _budget(0) {}
 
   int begin(int16_t rate, const DynamicFilterConfig& config, size_t axis)
   {
@@ -31,21 +43,35 @@ public:
     _rate = rate;
     _freq_min = config.min_freq;
     _freq_max = std::min(config.max_freq, nyquistLimit);
-    _peak_count = std::min((size_t)config.width, PEAKS_MAX);
+    _peak_count = (size_t)config.width < PEAKS_MAX ? config.width : PEAKS_MAX;
+    _budget = std::max((int)config.budget, 0);
 
     _idx = axis * SAMPLES / 3;
     _bin_width = (float)_rate / SAMPLES; // no need to dived by 2 as we next process `SAMPLES / 2` results
 
     _begin = (_freq_min / _bin_width) + 1;
     _end = std::min(BINS - 1, (size_t)(_freq_max / _bin_width)) - 1;
+    // peak search needs magnitude of one more bin on both sides only
+    _peak_units = _end >= _begin ? chunks(_end + 1 - _begin) : 1;
+    _mag_units = _end >= _begin ? chunks(_end + 3 - _begin) : 1;
 
+#if defined(ESPFC_DSP)
     // init fft tables
     dsps_fft4r_init_fc32(nullptr, BINS);
 
     // Generate hann window
     dsps_wind_hann_f32(_win, SAMPLES);
+#else
+    FFTReal<SAMPLES>::begin();
+
+    // same as dsps_wind_hann_f32()
+    for(size_t i = 0; i < SAMPLES; i++) _win[i] = 0.5f - 0.5f * cosf(2.f * pi() * i / (SAMPLES - 1));
+#endif
 
-    clearPeaks();
+    clearPeaks(peaks);
+    clearPeaks(_found);
+    _phase = PHASE_COLLECT;
+    _step = 0;
 
     for(size_t i = 0; i < SAMPLES; i++) _in[i] = 0;
     //std::fill(_in, _in + SAMPLES, 0);
@@ -53,53 +79,109 @@ public:
     return 1;
   }
 
-  // calculate fft and find noise peaks
+  // collect sample and continue analysis, returns 1 when new peaks are available
   int update(float v)
   {
     _in[_idx] = v;
 
     if(++_idx >= SAMPLES)
     {
+      // unfinished analysis is dropped, budget is too low for this sample size
       _idx = 0;
-      _phase = PHASE_FFT;
+      _phase = PHASE_WINDOW;
+      _step = 0;
     }
 
-    switch(_phase)
+    int status = 0;
+    for(size_t i = 0; (_budget == 0 || i < _budget) && _phase != PHASE_COLLECT; i++)
     {
-      case PHASE_COLLECT:
-        return 0;
+      status = step();
+    }
+    return status;
+  }
 
-      case PHASE_FFT: // 32us
-        // apply window function
-        for (size_t j = 0; j < SAMPLES; j++)
-        {
-          _out[j] = _in[j] * _win[j]; // real
-        }
+  // work units needed for one analysis
+  size_t units() const
+  {
+    return WINDOW_UNITS + FFT_UNITS + _mag_units + _peak_units + 1;
+  }
 
-        // FFT Radix-4
-        dsps_fft4r_fc32(_out, BINS);
+  size_t budget() const
+  {
+    return _budget;
+  }
 
-        // Bit reverse
-        dsps_bit_rev4r_fc32(_out, BINS);
+  static const size_t PEAKS_MAX = 8;
+  Peak peaks[PEAKS_MAX];
 
-        // Convert one complex vector with length SAMPLES/2 to one real spectrum vector with length SAMPLES/2
-        dsps_cplx2real_fc32(_out, BINS);
+private:
+  // single work unit, returns 1 after peaks are published
+  int step()
+  {
+    switch(_phase)
+    {
+      case PHASE_WINDOW:
+      {
+        // chunk stays ahead of new samples overwriting input, as at least one chunk is done per update
+        const size_t j0 = _step * CHUNK;
+        for(size_t j = j0; j < j0 + CHUNK; j++)
+        {
+          _out[j] = _in[j] * _win[j]; // real
+        }
+        next(WINDOW_UNITS, PHASE_FFT);
+        return 0;
+      }
 
-        _phase = PHASE_PEAKS;
+      case PHASE_FFT:
+#if defined(ESPFC_DSP)
+        switch(_step)
+        {
+          case 0:
+            // FFT Radix-4
+            dsps_fft4r_fc32(_out, BINS);
+            break;
+          case 1:
+            // Bit reverse
+            dsps_bit_rev4r_fc32(_out, BINS);
+            break;
+          default:
+            // Convert one complex vector with length SAMPLES/2 to one real spectrum vector with length SAMPLES/2
+            dsps_cplx2real_fc32(_out, BINS);
+            break;
+        }
+#else
+        // same output layout as above
+        FFTReal<SAMPLES>::stage(_out, _step);
+#endif
+        next(FFT_UNITS, PHASE_MAGNITUDE);
         return 0;
 
-      case PHASE_PEAKS: // 12us + 22us sqrt()
-        // calculate magnitude
-        for (size_t j = 0; j < BINS; j++)
+      case PHASE_MAGNITUDE:
+      {
+        // in place, bin j is read from 2j and 2j+1, which are not yet overwritten
+        const size_t j0 = _begin - 1 + _step * CHUNK;
+        const size_t j1 = std::min(j0 + CHUNK, _end + 2);
+        for(size_t j = j0; j < j1; j++)
         {
           size_t k = j * 2;
-          //_out[j] = _out[k] * _out[k] + _out[k + 1] * _out[k + 1];
           _out[j] = sqrt(_out[k] * _out[k] + _out[k + 1] * _out[k + 1]);
         }
+        next(_mag_units, PHASE_PEAKS);
+        return 0;
+      }
+
+      case PHASE_PEAKS:
+      {
+        const size_t b = _begin + _step * CHUNK;
+        const size_t e = std::min(b + CHUNK - 1, _end);
+        if(b <= e) Math::peakDetect(_out, b, e, _bin_width, _found, _peak_count, Math::PEAK_INTERP_GAUSSIAN);
+        next(_peak_units, PHASE_PUBLISH);
+        return 0;
+      }
 
-        clearPeaks();
-
-        Math::peakDetect(_out, _begin, _end, _bin_width, peaks, _peak_count);
+      case PHASE_PUBLISH:
+        std::copy(_found, _found + PEAKS_MAX, peaks);
+        clearPeaks(_found);
 
         // sort peaks by freq
         Math::peakSort(peaks, _peak_count);
@@ -113,17 +195,32 @@ public:
     }
   }
 
-  static const size_t PEAKS_MAX = 8;
-  Peak peaks[PEAKS_MAX];
+  void next(size_t count, FFTPhase phase)
+  {
+    if(++_step < count) return;
+    _step = 0;
+    _phase = phase;
+  }
 
-private:
-  void clearPeaks()
+  static void clearPeaks(Peak * p)
   {
-    for(size_t i = 0; i < PEAKS_MAX; i++) peaks[i] = Peak();
-    //std::fill(peaks, peaks + PEAKS_MAX, Peak());
+    for(size_t i = 0; i < PEAKS_MAX; i++) p[i] = Peak();
+  }
+
+  static constexpr size_t chunks(size_t n)
+  {
+    return (n + CHUNK - 1) / CHUNK;
   }
 
   static const size_t BINS = SAMPLES >> 1;
+  static const size_t CHUNK = 16;
+  static_assert(BINS % CHUNK == 0, "FFT size must be multiple of 32");
+  static const size_t WINDOW_UNITS = SAMPLES / CHUNK;
+#if defined(ESPFC_DSP)
+  static const size_t FFT_UNITS = 3;
+#else
+  static const size_t FFT_UNITS = FFTReal<SAMPLES>::STAGES;
+#endif
 
   int16_t _rate;
   int16_t _freq_min;
@@ -132,10 +229,16 @@ private:
 
   size_t _idx;
   FFTPhase _phase;
+  size_t _step;
+  size_t _budget;
   size_t _begin;
   size_t _end;
+  size_t _peak_units;
+  size_t _mag_units;
   float _bin_width;
 
+  Peak _found[PEAKS_MAX];
+
   // fft input
   __attribute__((aligned(16))) float _in[SAMPLES];
 
@@ -0,0 +1,142 @@
+#ifndef _ESPFC_MATH_FFT_REAL_H_
+#define _ESPFC_MATH_FFT_REAL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <utility>
+#include "Math/Utils.h"
+
+namespace Espfc {
+
+namespace Math {
+
+/**
+ * Portable real input FFT, used when esp-dsp is not available.
+ * N real samples are transformed as N/2 point complex radix-2 FFT followed by split step.
+ * Twiddle and bit reversal tables are computed in begin() and shared by all instances of same size.
+ */
+template<size_t N>
+class FFTReal
+{
+public:
+  static constexpr size_t HALF = N / 2;
+  static_assert(N >= 8 && (N & (N - 1)) == 0, "FFT size must be power of two");
+
+  static void begin()
+  {
+    size_t bits = 0;
+    while((1u << bits) < HALF) bits++;
+    for(size_t i = 0; i < HALF; i++)
+    {
+      size_t r = 0;
+      for(size_t b = 0; b < bits; b++) r |= ((i >> b) & 1) << (bits - 1 - b);
+      _rev[i] = r;
+    }
+    // e^-j2pi*k/N, complex stage uses every second entry
+    for(size_t k = 0; k < HALF; k++)
+    {
+      const float a = 2.f * pi() * k / N;
+      _cos[k] = cosf(a);
+      _sin[k] = sinf(a);
+    }
+  }
+
+  static constexpr size_t log2(size_t n)
+  {
+    return n <= 1 ? 0 : 1 + log2(n >> 1);
+  }
+
+  // bit reversal, butterfly stages, split
+  static constexpr size_t STAGES = log2(HALF) + 2;
+
+  // in place, input N real samples, output N/2 complex bins as re, im pairs
+  // bin 0 holds dc in re and nyquist in im, result is not scaled
+  static void forward(float * d)
+  {
+    for(size_t s = 0; s < STAGES; s++) stage(d, s);
+  }
+
+  // single step of forward(), for spreading transform over several calls
+  static void stage(float * d, size_t s)
+  {
+    if(s == 0) reorder(d);
+    else if(s < STAGES - 1) butterflies(d, 1u << s);
+    else split(d);
+  }
+
+private:
+  // samples as complex points z[n] = x[2n] + j * x[2n+1], in bit reversed order
+  static void reorder(float * d)
+  {
+    for(size_t i = 0; i < HALF; i++)
+    {
+      const size_t j = _rev[i];
+      if(j > i)
+      {
+        std::swap(d[2 * i], d[2 * j]);
+        std::swap(d[2 * i + 1], d[2 * j + 1]);
+      }
+    }
+  }
+
+  static void butterflies(float * d, size_t len)
+  {
+    const size_t half = len >> 1;
+    const size_t step = N / len;
+    for(size_t i = 0; i < HALF; i += len)
+    {
+      for(size_t k = 0; k < half; k++)
+      {
+        const float wr = _cos[k * step];
+        const float wi = _sin[k * step];
+        float * a = d + 2 * (i + k);
+        float * b = a + 2 * half;
+        // b * e^-jw
+        const float tr = b[0] * wr + b[1] * wi;
+        const float ti = b[1] * wr - b[0] * wi;
+        b[0] = a[0] - tr;
+        b[1] = a[1] - ti;
+        a[0] += tr;
+        a[1] += ti;
+      }
+    }
+  }
+
+  // split even and odd spectra, X[k] = E[k] + W^k * O[k], X[N/2 - k] = conj(E[k] - W^k * O[k])
+  static void split(float * d)
+  {
+    const float z0r = d[0], z0i = d[1];
+    d[0] = z0r + z0i;
+    d[1] = z0r - z0i;
+    for(size_t k = 1; k <= HALF / 2; k++)
+    {
+      float * a = d + 2 * k;
+      float * b = d + 2 * (HALF - k);
+      const float er = 0.5f * (a[0] + b[0]);
+      const float ei = 0.5f * (a[1] - b[1]);
+      const float or_ = 0.5f * (a[1] + b[1]);
+      const float oi = -0.5f * (a[0] - b[0]);
+      const float tr = or_ * _cos[k] + oi * _sin[k];
+      const float ti = oi * _cos[k] - or_ * _sin[k];
+      a[0] = er + tr;
+      a[1] = ei + ti;
+      b[0] = er - tr;
+      b[1] = ti - ei;
+    }
+  }
+
+  static uint16_t _rev[HALF];
+  static float _cos[HALF];
+  static float _sin[HALF];
+};
+
+template<size_t N> uint16_t FFTReal<N>::_rev[FFTReal<N>::HALF];
+template<size_t N> float FFTReal<N>::_cos[FFTReal<N>::HALF];
+template<size_t N> float FFTReal<N>::_sin[FFTReal<N>::HALF];
+
+}
+
+}
+
+#endif
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+
+namespace Espfc {
+
+namespace Math {
+
+  // fixed point formats used by integer filters
+  // q16: signal samples, Q16.16, range +/-32768, resolution 1.5e-5
+  // q20: pid gains and mixer rates, Q12.20, range +/-2048, resolution 1e-6
+  // q30: filter coefficients, Q2.30, range +/-2
+  // q31: gains in range [0, 1)
+  constexpr int Q16_BITS = 16;
+  constexpr int Q20_BITS = 20;
+  constexpr int Q30_BITS = 30;
+  constexpr int Q31_BITS = 31;
+
+  template<int bits>
+  inline int32_t toFixed(float v)
+  {
+    const float scaled = v * (float)(1ul << bits);
+    // saturate, conversion of out of range float is undefined
+    if(scaled >= 2147483647.f) return INT32_MAX;
+    if(scaled <= -2147483648.f) return INT32_MIN;
+    return (int32_t)lrintf(scaled);
+  }
+
+  template<int bits>
+  inline float fromFixed(int32_t v)
+  {
+    return v * (1.f / (float)(1ul << bits));
+  }
+
+  // multiply with rounding, result has format of a
+  template<int bits>
+  inline int32_t mulFixed(int32_t a, int32_t b)
+  {
+    return (int32_t)(((int64_t)a * b + (1ll << (bits - 1))) >> bits);
+  }
+
+  // accumulated products, shifted back with rounding once
+  template<int bits>
+  inline int32_t roundFixed(int64_t acc)
+  {
+    return (int32_t)((acc + (1ll << (bits - 1))) >> bits);
+  }
+
+  inline int32_t toQ16(float v) { return toFixed<Q16_BITS>(v); }
+  inline float fromQ16(int32_t v) { return fromFixed<Q16_BITS>(v); }
+
+  inline int32_t toQ20(float v) { return toFixed<Q20_BITS>(v); }
+
+  inline int32_t toQ30(float v) { return toFixed<Q30_BITS>(v); }
+  inline int32_t mulQ30(int32_t a, int32_t q30) { return mulFixed<Q30_BITS>(a, q30); }
+
+  inline int32_t toQ31(float v) { return toFixed<Q31_BITS>(v); }
+  inline int32_t mulQ31(int32_t a, int32_t q31) { return mulFixed<Q31_BITS>(a, q31); }
+
+}
+
+}
@@ -0,0 +1,155 @@
+#ifndef _ESPFC_MATH_SDFT_ANALYZER_H_
+#define _ESPFC_MATH_SDFT_ANALYZER_H_
+
+// https://www.dsprelated.com/showarticle/776.php
+
+#include "Math/Utils.h"
+#include "Filter.h"
+#include <algorithm>
+
+namespace Espfc {
+
+namespace Math {
+
+/**
+ * Sliding DFT noise analyzer, drop-in replacement for FFTAnalyzer.
+ * Only bins within min_freq..max_freq are tracked, all of them are updated on every sample.
+ * Hann window is applied in frequency domain, magnitude and peak test run for one bin per sample,
+ * so cost of update() is the same for every sample, peaks are published after each sweep of the range.
+ */
+template<size_t SAMPLES>
+class SdftAnalyzer
+{
+public:
+  SdftAnalyzer(): _idx(0), _cursor(0), _first(0), _last(0) {}
+
+  int begin(int16_t rate, const DynamicFilterConfig& config, size_t axis)
+  {
+    int16_t nyquistLimit = rate / 2;
+    _rate = rate;
+    _freq_min = config.min_freq;
+    _freq_max = std::min(config.max_freq, nyquistLimit);
+    _peak_count = (size_t)config.width < PEAKS_MAX ? config.width : PEAKS_MAX;
+
+    _bin_width = (float)_rate / SAMPLES;
+
+    // peak search range as in FFTAnalyzer, window needs two more bins on both sides
+    _begin = std::max((size_t)(_freq_min / _bin_width) + 1, (size_t)2);
+    _end = std::min(BINS - 1, (size_t)(_freq_max / _bin_width)) - 1;
+    if(_end < _begin) _end = _begin;
+    _first = _begin - 2;
+    _last = _end + 2;
+
+    // damping keeps accumulated rounding errors bounded
+    _damp_n = 1.f;
+    for(size_t i = 0; i < SAMPLES; i++) _damp_n *= DAMP;
+
+    for(size_t k = _first; k <= _last; k++)
+    {
+      const float a = 2.f * pi() * k / SAMPLES;
+      _tw_re[k] = cosf(a);
+      _tw_im[k] = sinf(a);
+    }
+
+    std::fill(_in, _in + SAMPLES, 0.f);
+    std::fill(_re, _re + BINS + 1, 0.f);
+    std::fill(_im, _im + BINS + 1, 0.f);
+    std::fill(_mag, _mag + BINS + 1, 0.f);
+
+    clearPeaks(peaks);
+    clearPeaks(_found);
+
+    // spread sweep ends of axes over different samples
+    _idx = 0;
+    _cursor = axis * (_last - _first - 1) / 3;
+
+    return 1;
+  }
+
+  // update spectrum and scan next bin, returns 1 when new peaks are available
+  int update(float v)
+  {
+    const float delta = v - _damp_n * _in[_idx];
+    _in[_idx] = v;
+    if(++_idx >= SAMPLES) _idx = 0;
+
+    for(size_t k = _first; k <= _last; k++)
+    {
+      const float re = DAMP * _re[k] + delta;
+      const float im = DAMP * _im[k];
+      _re[k] = re * _tw_re[k] - im * _tw_im[k];
+      _im[k] = re * _tw_im[k] + im * _tw_re[k];
+    }
+
+    // hann window as convolution with neighbour bins
+    const size_t b = _first + 1 + _cursor;
+    const float re = 0.5f * _re[b] - 0.25f * (_re[b - 1] + _re[b + 1]);
+    const float im = 0.5f * _im[b] - 0.25f * (_im[b - 1] + _im[b + 1]);
+    _mag[b] = sqrtf(re * re + im * im);
+
+    // previous bin has both neighbours ready now
+    if(b > _begin)
+    {
+      Math::peakDetect(_mag, b - 1, b - 1, _bin_width, _found, _peak_count, Math::PEAK_INTERP_GAUSSIAN);
+    }
+
+    if(b < _end + 1)
+    {
+      _cursor++;
+      return 0;
+    }
+
+    _cursor = 0;
+    std::copy(_found, _found + PEAKS_MAX, peaks);
+    clearPeaks(_found);
+
+    // sort peaks by freq
+    Math::peakSort(peaks, _peak_count);
+
+    return 1;
+  }
+
+  static const size_t PEAKS_MAX = 8;
+  Peak peaks[PEAKS_MAX];
+
+private:
+  static void clearPeaks(Peak * p)
+  {
+    for(size_t i = 0; i < PEAKS_MAX; i++) p[i] = Peak();
+  }
+
+  static const size_t BINS = SAMPLES >> 1;
+  static constexpr float DAMP = 0.9999f;
+
+  int16_t _rate;
+  int16_t _freq_min;
+  int16_t _freq_max;
+  int16_t _peak_count;
+
+  size_t _idx;
+  size_t _cursor;
+  size_t _begin;
+  size_t _end;
+  size_t _first;
+  size_t _last;
+  float _bin_width;
+  float _damp_n;
+
+  Peak _found[PEAKS_MAX];
+
+  // input history
+  float _in[SAMPLES];
+
+  // tracked bins, indexed by bin number
+  float _re[BINS + 1];
+  float _im[BINS + 1];
+  float _tw_re[BINS + 1];
+  float _tw_im[BINS + 1];
+  float _mag[BINS + 1];
+};
+
+}
+
+}
+
+#endif
@@ -0,0 +1,59 @@
+#include <cmath>
+#include "SinCos.h"
+#include "Utils.h"
+#include "Utils/MemoryHelper.h"
+
+namespace Espfc {
+
+namespace Math {
+
+namespace {
+
+constexpr size_t SIN_TABLE_SIZE = 256; // segments per quarter wave
+
+class SinTable
+{
+  public:
+    SinTable()
+    {
+      for(size_t i = 0; i <= SIN_TABLE_SIZE; i++)
+      {
+        v[i] = sinf(i * (0.5f * pi() / SIN_TABLE_SIZE));
+      }
+    }
+    float v[SIN_TABLE_SIZE + 1];
+};
+
+// filled on first use, kept in ram
+const SinTable& sinTable()
+{
+  static const SinTable table;
+  return table;
+}
+
+}
+
+void FAST_CODE_ATTR sinCos(float x, float& s, float& c)
+{
+  const float * v = sinTable().v;
+
+  // reduce to first quarter, sin is symmetric around pi/2, cos changes sign
+  x = clamp(x, 0.f, pi());
+  const bool upper = x > 0.5f * pi();
+  if(upper) x = pi() - x;
+
+  const float idx = x * (SIN_TABLE_SIZE / (0.5f * pi()));
+  size_t i = (size_t)idx;
+  if(i >= SIN_TABLE_SIZE) i = SIN_TABLE_SIZE - 1;
+  const float f = idx - i;
+
+  // cos(x) = sin(pi/2 - x), same segment walked from the other end
+  const size_t j = SIN_TABLE_SIZE - i;
+  s = v[i] + f * (v[i + 1] - v[i]);
+  c = v[j] + f * (v[j - 1] - v[j]);
+  if(upper) c = -c;
+}
+
+}
+
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Espfc {
+
+namespace Math {
+
+// sine and cosine of x in range [0, pi] from quarter wave lookup table with linear interpolation,
+// max absolute error is about 5e-6, input outside of range is clamped
+void sinCos(float x, float& s, float& c);
+
+}
+
+}
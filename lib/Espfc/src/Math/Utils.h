@@ -99,35 +99,61 @@ public:
     return 44330.f * (1.f - std::pow(pressure / seaLevelPressure, 0.1903f));
   }
 
-  inline void peakDetect(float * samples, size_t begin_bin, size_t end_bin, float bin_width, Peak * peaks, size_t peak_count)
+  enum PeakInterpolation {
+    PEAK_INTERP_WEIGHTED,  // weighted average of three bins
+    PEAK_INTERP_QUADRATIC, // parabola fitted to magnitude
+    PEAK_INTERP_GAUSSIAN,  // parabola fitted to log magnitude, most accurate for hann window
+  };
+
+  // offset of true peak from center bin, in bins, kl and kh must be lower than k0
+  inline float peakOffset(float kl, float k0, float kh, PeakInterpolation interp)
   {
-    for(size_t b = begin_bin; b <= end_bin; b++)
+    switch(interp)
     {
-      if(samples[b] > samples[b - 1] && samples[b] > samples[b + 1])
+      case PEAK_INTERP_GAUSSIAN:
+        if(kl > 0.f && kh > 0.f)
+        {
+          kl = logf(kl);
+          k0 = logf(k0);
+          kh = logf(kh);
+        }
+        // fall through
+      case PEAK_INTERP_QUADRATIC:
       {
-        float f0 = b * bin_width;
-        float k0 = samples[b];
-
-        float fl = f0 - bin_width;
-        float kl = samples[b - 1];
-
-        float fh = f0 + bin_width;
-        float kh = samples[b + 1];
+        const float d = kl - 2.f * k0 + kh;
+        return d < 0.f ? 0.5f * (kl - kh) / d : 0.f;
+      }
+      default:
+        return (kh - kl) / (kl + k0 + kh);
+    }
+  }
 
-        // weighted average
-        float centerFreq = (k0 * f0 + kl * fl + kh * fh) / (k0 + kl + kh);
+  // index of weakest peak, if equal the one with higher freq, as it was detected later
+  inline size_t peakWeakest(const Peak * peaks, size_t peak_count)
+  {
+    size_t w = 0;
+    for(size_t p = 1; p < peak_count; p++)
+    {
+      if(peaks[p].value < peaks[w].value || (peaks[p].value == peaks[w].value && peaks[p].freq > peaks[w].freq)) w = p;
+    }
+    return w;
+  }
 
-        for(size_t p = 0; p < peak_count; p++)
+  // keep peak_count strongest local maxima in peaks, result is not ordered, use peakSort()
+  inline void peakDetect(float * samples, size_t begin_bin, size_t end_bin, float bin_width, Peak * peaks, size_t peak_count, PeakInterpolation interp = PEAK_INTERP_WEIGHTED)
+  {
+    if(!peak_count) return;
+    size_t weakest = peakWeakest(peaks, peak_count);
+    for(size_t b = begin_bin; b <= end_bin; b++)
+    {
+      const float k0 = samples[b];
+      if(k0 > samples[b - 1] && k0 > samples[b + 1])
+      {
+        if(k0 > peaks[weakest].value)
         {
-          if(samples[b] > peaks[p].value)
-          {
-            for(size_t k = (peak_count - 1); k > p; k--)
-            {
-              peaks[k] = peaks[k - 1];
-            }
-            peaks[p] = Peak(centerFreq, samples[b]);
-            break;
-          }
+          const float offset = peakOffset(samples[b - 1], k0, samples[b + 1], interp);
+          peaks[weakest] = Peak((b + offset) * bin_width, k0);
+          weakest = peakWeakest(peaks, peak_count);
         }
         b++; // next bin can't be peak
       }
@@ -24,7 +24,7 @@ class Model
     void initialize()
     {
       config = ModelConfig();
-      #ifdef UNIT_TEST
+      #if defined(UNIT_TEST) && !defined(ESPFC_SITL)
       state = ModelState(); // FIXME: causes board wdt reset
       #endif
       //config.brobot();
@@ -98,7 +98,12 @@ class Model
 
     bool isThrottleLow() const
     {
-      return state.inputUs[AXIS_THRUST] < config.input.minCheck;
+      return isThrottleLow(state.inputUs);
+    }
+
+    bool isThrottleLow(const float * inputUs) const
+    {
+      return inputUs[AXIS_THRUST] < config.input.minCheck;
     }
 
     bool blackboxEnabled() const
@@ -436,6 +441,7 @@ class Model
       state.dynamicFilterTimer.setRate(50);
       state.telemetryTimer.setInterval(config.telemetryInterval * 1000);
       state.stats.timer.setRate(3);
+      state.stats.begin(targetCycleFreq());
       if(magActive())
       {
         state.magTimer.setRate(state.magRate);
@@ -449,38 +455,40 @@ class Model
       const uint32_t pidFilterRate = state.loopTimer.rate;
 
       // configure filters
-      for(size_t i = 0; i <= AXIS_YAW; i++)
+      if(isActive(FEATURE_DYNAMIC_FILTER))
       {
-        if(isActive(FEATURE_DYNAMIC_FILTER))
-        {
-          for(size_t p = 0; p < (size_t)config.dynamicFilter.width; p++)
-          {
-            state.gyroDynNotchFilter[p][i].begin(FilterConfig(FILTER_NOTCH_DF1, 400, 380), gyroFilterRate);
-          }
-        }
-        state.gyroNotch1Filter[i].begin(config.gyroNotch1Filter, gyroFilterRate);
-        state.gyroNotch2Filter[i].begin(config.gyroNotch2Filter, gyroFilterRate);
-        if(config.gyroDynLpfFilter.cutoff > 0)
+        for(size_t p = 0; p < (size_t)config.dynamicFilter.width; p++)
         {
-          state.gyroFilter[i].begin(FilterConfig((FilterType)config.gyroFilter.type, config.gyroDynLpfFilter.cutoff), gyroFilterRate);
+          state.gyroDynNotchFilter[p].begin(FilterConfig(FILTER_NOTCH_DF1, 400, 380), gyroFilterRate);
+          state.gyroDynNotchFilter[p].setRamp(config.gyroNotchRamp);
         }
-        else
+      }
+      state.gyroNotch1Filter.begin(config.gyroNotch1Filter, gyroFilterRate);
+      state.gyroNotch2Filter.begin(config.gyroNotch2Filter, gyroFilterRate);
+      if(config.gyroDynLpfFilter.cutoff > 0)
+      {
+        state.gyroFilter.begin(FilterConfig((FilterType)config.gyroFilter.type, config.gyroDynLpfFilter.cutoff), gyroFilterRate);
+      }
+      else
+      {
+        state.gyroFilter.begin(config.gyroFilter, gyroFilterRate);
+      }
+      state.gyroFilter2.begin(config.gyroFilter2, gyroFilterRate);
+      state.gyroFilter3.begin(config.gyroFilter3, gyroPreFilterRate);
+      state.gyroImuFilter.begin(FilterConfig(FILTER_PT1, state.accelTimer.rate / 3), gyroFilterRate);
+      state.rpmFilter.begin(gyroFilterRate, config.rpmFilterHarmonics, config.gyroNotchRamp);
+      for(size_t m = 0; m < RPM_FILTER_MOTOR_MAX; m++)
+      {
+        state.rpmFreqFilter[m].begin(FilterConfig(FILTER_PT1, config.rpmFilterFreqLpf), gyroFilterRate);
+        for(size_t n = 0; n < config.rpmFilterHarmonics; n++)
         {
-          state.gyroFilter[i].begin(config.gyroFilter, gyroFilterRate);
+          int center = Math::mapi(m * RPM_FILTER_HARMONICS_MAX + n, 0, RPM_FILTER_MOTOR_MAX * config.rpmFilterHarmonics, config.rpmFilterMinFreq, gyroFilterRate / 2);
+          state.rpmFilter.reconfigure(m, n, center, config.rpmFilterQ * 0.01f);
         }
-        state.gyroFilter2[i].begin(config.gyroFilter2, gyroFilterRate);
-        state.gyroFilter3[i].begin(config.gyroFilter3, gyroPreFilterRate);
+      }
+      for(size_t i = 0; i <= AXIS_YAW; i++)
+      {
         state.accelFilter[i].begin(config.accelFilter, gyroFilterRate);
-        state.gyroImuFilter[i].begin(FilterConfig(FILTER_PT1, state.accelTimer.rate / 3), gyroFilterRate);
-        for(size_t m = 0; m < RPM_FILTER_MOTOR_MAX; m++)
-        {
-          state.rpmFreqFilter[m].begin(FilterConfig(FILTER_PT1, config.rpmFilterFreqLpf), gyroFilterRate);
-          for(size_t n = 0; n < config.rpmFilterHarmonics; n++)
-          {
-            int center = Math::mapi(m * RPM_FILTER_HARMONICS_MAX + n, 0, RPM_FILTER_MOTOR_MAX * config.rpmFilterHarmonics, config.rpmFilterMinFreq, gyroFilterRate / 2);
-            state.rpmFilter[m][n][i].begin(FilterConfig(FILTER_NOTCH_DF1, center, center * 0.98f), gyroFilterRate);
-          }
-        }
         if(magActive())
         {
           state.magFilter[i].begin(config.magFilter, state.magTimer.rate);
@@ -561,6 +569,7 @@ class Model
         pid.begin();
       }
       state.customMixer = MixerConfig(config.customMixerCount, config.customMixes);
+      state.mixerChanged = true;
 
       // override temporary
       //state.telemetryTimer.setRate(100);
@@ -448,6 +448,10 @@ class OutputConfig
     int8_t throttleLimitPercent = 100;
     int8_t motorLimit = 100;
 
+    int8_t thrustLinear = 0;        // percent, low output boost
+    int8_t vbatSagCompensation = 0; // percent
+    int8_t motorScale[ESPFC_OUTPUT_COUNT]; // percent, 50-100
+
     OutputChannelConfig channel[ESPFC_OUTPUT_COUNT];
 };
 
@@ -630,6 +634,7 @@ class ModelConfig
     uint8_t rpmFilterFreqLpf;
     uint8_t rpmFilterWeights[RPM_FILTER_HARMONICS_MAX];
     uint8_t rpmFilterFade;
+    uint8_t gyroNotchRamp;
 
     uint8_t rescueConfigDelay = 30;
 
@@ -732,6 +737,7 @@ class ModelConfig
       rpmFilterWeights[1] = 100;
       rpmFilterWeights[2] = 100;
       rpmFilterFreqLpf = 150;
+      gyroNotchRamp = 0;
 
       gyroFilter3 = FilterConfig(FILTER_FO, 150);
       gyroNotch1Filter = FilterConfig(FILTER_NOTCH, 0, 0); // off
@@ -790,6 +796,7 @@ class ModelConfig
         output.channel[i].min = 1000;
         output.channel[i].max = 2000;
         output.channel[i].neutral = 1500;
+        output.motorScale[i] = 100;
       }
 
       mixerType = FC_MIXER_QUADX;
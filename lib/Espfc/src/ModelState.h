@@ -13,11 +13,15 @@
 #include "Control/Pid.h"
 #include "Kalman.h"
 #include "Filter.h"
+#include "FilterBank3.h"
+#include "RpmFilter.h"
 #include "Stats.h"
 #include "Timer.h"
+#include "Scheduler.h"
 #include "Device/SerialDevice.h"
 #include "Math/FreqAnalyzer.h"
 #include "Msp/Msp.h"
+#include "Target/SeqLock.h"
 
 namespace Espfc {
 
@@ -141,6 +145,30 @@ enum RescueConfigMode {
 };
 
 // working data
+// gyro task to pid task payload
+struct GyroSample
+{
+  VectorFloat gyro;
+  uint32_t timestamp;
+};
+
+// input task to pid task payload
+struct InputSnapshot
+{
+  float input[INPUT_CHANNELS];
+  float inputUs[INPUT_CHANNELS];
+};
+
+// mixer to serial task payload
+struct TelemetrySnapshot
+{
+  float rpm[OUTPUT_CHANNELS];
+  int16_t errors[OUTPUT_CHANNELS];
+  int8_t temperature[OUTPUT_CHANNELS];
+  int8_t voltage[OUTPUT_CHANNELS];
+  int8_t current[OUTPUT_CHANNELS];
+};
+
 struct ModelState
 {
   Device::GyroDevice* gyroDev;
@@ -177,19 +205,20 @@ struct ModelState
 
   RotationMatrixFloat boardAlignment;
 
-  Filter gyroFilter[3];
-  Filter gyroFilter2[3];
-  Filter gyroFilter3[3];
-  Filter gyroNotch1Filter[3];
-  Filter gyroNotch2Filter[3];
-  Filter gyroDynNotchFilter[6][3];
-  Filter gyroImuFilter[3];
+  FilterBank3 gyroFilter;
+  FilterBank3 gyroFilter2;
+  FilterBank3 gyroFilter3;
+  FilterBank3 gyroNotch1Filter;
+  FilterBank3 gyroNotch2Filter;
+  FilterBank3 gyroDynNotchFilter[6];
+  FilterBank3 gyroImuFilter;
 
   Filter accelFilter[3];
   Filter magFilter[3];
   Filter inputFilter[4];
   Filter rpmFreqFilter[RPM_FILTER_MOTOR_MAX];
-  Filter rpmFilter[RPM_FILTER_MOTOR_MAX][RPM_FILTER_HARMONICS_MAX][3];
+  static_assert(RpmFilter::MOTORS == RPM_FILTER_MOTOR_MAX && RpmFilter::HARMONICS == RPM_FILTER_HARMONICS_MAX, "RpmFilter size must match rpm filter config");
+  RpmFilter rpmFilter;
 
   VectorFloat velocity;
   VectorFloat desiredVelocity;
@@ -223,6 +252,7 @@ struct ModelState
 
   float inputUs[INPUT_CHANNELS];
   float input[INPUT_CHANNELS];
+  InputSnapshot inputSampled;
   FailsafeState failsafe;
 
   float output[OUTPUT_CHANNELS];
@@ -243,6 +273,7 @@ struct ModelState
   int8_t outputTelemetryDebug2[OUTPUT_CHANNELS];
   int8_t outputTelemetryDebug3[OUTPUT_CHANNELS];
   int8_t outputTelemetryEvents[OUTPUT_CHANNELS];
+  TelemetrySnapshot outputTelemetrySampled;
 
   // other state
   Kalman kalman[AXES];
@@ -312,6 +343,7 @@ struct ModelState
 
   MixerConfig currentMixer;
   MixerConfig customMixer;
+  bool mixerChanged;
 
   int16_t i2cErrorCount;
   int16_t i2cErrorDelta;
@@ -338,7 +370,13 @@ struct ModelState
   SerialPortState serial[SERIAL_UART_COUNT];
   Timer serialTimer;
 
+  Scheduler scheduler;
   Target::Queue appQueue;
+#if defined(ESPFC_MULTI_CORE)
+  SeqLock<GyroSample> gyroSample;
+  SeqLock<InputSnapshot> inputSample;
+  SeqLock<TelemetrySnapshot> outputTelemetrySample;
+#endif
   EscDriver * escMotor;
   EscDriver * escServo;
 };
@@ -3,6 +3,7 @@
 
 #include "Msp/Msp.h"
 #include "Model.h"
+#include "Utils/FilterLatency.h"
 #include "Hardware.h"
 #include "Msp/MspParser.h"
 #include "platform.h"
@@ -149,9 +150,21 @@ static uint16_t toIbatCurrent(float current)
   return constrain(lrintf(current * 100.0f), -32000, 32000);
 }
 
+static uint16_t toDelayMicros(float delay)
+{
+  return constrain(lrintf(delay * 1e6f), 0, 65535);
+}
+
+static uint16_t toMicros(float us)
+{
+  return constrain(lrintf(us), 0, 65535);
+}
+
 }
 
 #define MSP_PASSTHROUGH_ESC_4WAY 0xff
+#define MSP2_ESPFC_FILTER_LATENCY 0x4000
+#define MSP2_ESPFC_STATS_LATENCY 0x4001
 
 namespace Espfc {
 
@@ -1320,6 +1333,9 @@ class MspProcessor
           break;
 
         case MSP_MOTOR_TELEMETRY:
+#if defined(ESPFC_MULTI_CORE)
+          _model.state.outputTelemetrySample.receive(_model.state.outputTelemetrySampled);
+#endif
           r.writeU8(OUTPUT_CHANNELS);
           for (size_t i = 0; i < OUTPUT_CHANNELS; i++)
           {
@@ -1332,11 +1348,12 @@ class MspProcessor
 
             if (_model.config.pin[i + PIN_OUTPUT_0] != -1)
             {
-              rpm = lrintf(_model.state.outputTelemetryRpm[i]);
-              invalidPct = _model.state.outputTelemetryErrors[i];
-              escTemperature = _model.state.outputTelemetryTemperature[i];
-              escVoltage = _model.state.outputTelemetryVoltage[i];
-              escCurrent = _model.state.outputTelemetryCurrent[i];
+              const TelemetrySnapshot& t = _model.state.outputTelemetrySampled;
+              rpm = lrintf(t.rpm[i]);
+              invalidPct = t.errors[i];
+              escTemperature = t.temperature[i];
+              escVoltage = t.voltage[i];
+              escCurrent = t.current[i];
             }
 
             r.writeU32(rpm);
@@ -1474,6 +1491,61 @@ class MspProcessor
           }
           break;
 
+        case MSP2_ESPFC_FILTER_LATENCY:
+          {
+            // request: optional list of u16 frequencies [Hz]
+            // response: stage count, freq count, then per freq: freq, delay of each stage, gyro and dterm total [us]
+            const size_t stages = Utils::FilterLatency::STAGE_COUNT;
+            const size_t freqMax = (r.remain() - 2) / ((stages + 3) * 2);
+            uint16_t freqs[8];
+            size_t count = 0;
+            while(m.remain() >= 2 && count < freqMax && count < 8)
+            {
+              uint16_t f = m.readU16();
+              if(f > 0) freqs[count++] = f;
+            }
+            if(!count)
+            {
+              for(; count < Utils::FilterLatency::DEFAULT_FREQ_COUNT; count++) freqs[count] = Utils::FilterLatency::defaultFreq(count);
+            }
+            Utils::FilterLatency latency(_model);
+            r.writeU8(stages);
+            r.writeU8(count);
+            for(size_t i = 0; i < count; i++)
+            {
+              latency.compute(freqs[i]);
+              r.writeU16(freqs[i]);
+              for(size_t j = 0; j < stages; j++) r.writeU16(toDelayMicros(latency.delay[j]));
+              r.writeU16(toDelayMicros(latency.gyro()));
+              r.writeU16(toDelayMicros(latency.dterm()));
+            }
+          }
+          break;
+
+        case MSP2_ESPFC_STATS_LATENCY:
+          {
+            // request: optional u8 first counter, optional u8 reset flag
+            // response: counter count, first counter, counters in reply, then per counter: min, p50, p90, p99, p99.9, max [us]
+            const uint8_t first = m.remain() >= 1 ? std::min((int)m.readU8(), (int)COUNTER_COUNT) : 0;
+            const size_t count = std::min((size_t)(COUNTER_COUNT - first), (size_t)(r.remain() - 3) / 12);
+            r.writeU8(COUNTER_COUNT);
+            r.writeU8(first);
+            r.writeU8(count);
+            for(size_t i = first; i < first + count; i++)
+            {
+              const Stats& stats = _model.state.stats;
+              const StatCounter c = (StatCounter)i;
+              r.writeU16(toMicros(stats.getMin(c)));
+              r.writeU16(toMicros(stats.getPercentile(c, 0.5f)));
+              r.writeU16(toMicros(stats.getPercentile(c, 0.9f)));
+              r.writeU16(toMicros(stats.getPercentile(c, 0.99f)));
+              r.writeU16(toMicros(stats.getPercentile(c, 0.999f)));
+              r.writeU16(toMicros(stats.getMax(c)));
+            }
+            if(m.remain() >= 1 && m.readU8()) _model.state.stats.reset();
+          }
+          break;
+
         case MSP_EEPROM_WRITE:
           _model.save();
           break;
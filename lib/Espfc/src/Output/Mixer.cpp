@@ -76,6 +76,9 @@ int Mixer::begin()
     _model.state.maxThrottle = 2000.f;
   }
   _model.state.currentMixer = Mixers::getMixer((MixerType)_model.config.mixerType, _model.state.customMixer);
+  _model.state.mixerChanged = false;
+  _matrix.compile(_model.state.currentMixer);
+  _curve.begin(_model.config.output, _model.state.battery.cellVoltage);
   return 1;
 }
 
@@ -86,8 +89,15 @@ int FAST_CODE_ATTR Mixer::update()
   float outputs[OUTPUT_CHANNELS];
   const MixerConfig& mixer = _model.state.currentMixer;
 
+  // custom mixer rules are editable at runtime
+  if(_model.state.mixerChanged)
+  {
+    _model.state.mixerChanged = false;
+    _matrix.compile(mixer);
+  }
+
   readTelemetry();
-  updateMixer(mixer, outputs);
+  updateMixer(_matrix, outputs);
   writeOutput(mixer, outputs);
 
   if(_model.config.debugMode == DEBUG_PIDLOOP)
@@ -106,9 +116,15 @@ int FAST_CODE_ATTR Mixer::update()
   return 1;
 }
 
-void FAST_CODE_ATTR Mixer::updateMixer(const MixerConfig& mixer, float * outputs)
+void Mixer::updateCurve()
+{
+  _curve.update(_model.state.battery.cellVoltage);
+}
+
+void FAST_CODE_ATTR Mixer::updateMixer(const MixerMatrix& matrix, float * outputs)
 {
   Stats::Measure mixerMeasure(_model.state.stats, COUNTER_MIXER);
+  const size_t count = matrix.count();
 
   float sources[MIXER_SOURCE_MAX];
   sources[MIXER_SOURCE_NULL]   = 0;
@@ -118,14 +134,14 @@ void FAST_CODE_ATTR Mixer::updateMixer(const MixerConfig& mixer, float * outputs
   sources[MIXER_SOURCE_YAW]    = _model.state.output[AXIS_YAW] * (_model.config.yawReverse ? 1.f : -1.f);
   sources[MIXER_SOURCE_THRUST] = _model.state.output[AXIS_THRUST];
 
-  sources[MIXER_SOURCE_RC_ROLL]   = _model.state.input[AXIS_ROLL];
-  sources[MIXER_SOURCE_RC_PITCH]  = _model.state.input[AXIS_PITCH];
-  sources[MIXER_SOURCE_RC_YAW]    = _model.state.input[AXIS_YAW];
-  sources[MIXER_SOURCE_RC_THRUST] = _model.state.input[AXIS_THRUST];
+  sources[MIXER_SOURCE_RC_ROLL]   = _model.state.inputSampled.input[AXIS_ROLL];
+  sources[MIXER_SOURCE_RC_PITCH]  = _model.state.inputSampled.input[AXIS_PITCH];
+  sources[MIXER_SOURCE_RC_YAW]    = _model.state.inputSampled.input[AXIS_YAW];
+  sources[MIXER_SOURCE_RC_THRUST] = _model.state.inputSampled.input[AXIS_THRUST];
 
   for(size_t i = 0; i < 3; i++)
   {
-    sources[MIXER_SOURCE_RC_AUX1 + i] = _model.state.input[AXIS_AUX_1 + i];
+    sources[MIXER_SOURCE_RC_AUX1 + i] = _model.state.inputSampled.input[AXIS_AUX_1 + i];
   }
   
   for(size_t i = 0; i < OUTPUT_CHANNELS; i++)
@@ -134,24 +150,14 @@ void FAST_CODE_ATTR Mixer::updateMixer(const MixerConfig& mixer, float * outputs
   }
 
   // mix stabilized sources first
-  const MixerEntry * entry = mixer.mixes;
-  const MixerEntry * end = mixer.mixes + MIXER_RULE_MAX;
-  while(entry != end)
-  {
-    if(entry->src == MIXER_SOURCE_NULL) break; // break on terminator
-    if(entry->src <= MIXER_SOURCE_YAW && entry->dst < mixer.count && entry->rate != 0)
-    {
-      outputs[entry->dst] += sources[entry->src] * (entry->rate * 0.01f);
-    }
-    entry++;
-  }
+  matrix.mixStabilized(sources + MIXER_SOURCE_ROLL, outputs);
 
   // airmode logic
   float thrust = limitThrust(sources[MIXER_SOURCE_THRUST], (ThrottleLimitType)_model.config.output.throttleLimitType, _model.config.output.throttleLimitPercent);
   if(_model.isAirModeActive())
   {
     float min = 0.f, max = 0.f;
-    for(size_t i = 0; i < mixer.count; i++)
+    for(size_t i = 0; i < count; i++)
     {
       max = std::max(max, outputs[i]);
       min = std::min(min, outputs[i]);
@@ -159,7 +165,7 @@ void FAST_CODE_ATTR Mixer::updateMixer(const MixerConfig& mixer, float * outputs
     float range = (max - min) * 0.5f;
     if(range > 1.f)
     {
-      for(size_t i = 0; i < mixer.count; i++)
+      for(size_t i = 0; i < count; i++)
       {
         outputs[i] /= range;
       }
@@ -172,26 +178,14 @@ void FAST_CODE_ATTR Mixer::updateMixer(const MixerConfig& mixer, float * outputs
   }
 
   // apply other channels
-  entry = mixer.mixes;
-  while(entry != end)
-  {
-    if(entry->src == MIXER_SOURCE_NULL) break; // break on terminator
-    if(entry->dst < mixer.count)
-    {
-      if(entry->src == MIXER_SOURCE_THRUST)
-      {
-        outputs[entry->dst] += thrust * (entry->rate * 0.01f);
-      }
-      else if(entry->src > MIXER_SOURCE_THRUST && entry->src < MIXER_SOURCE_MAX)
-      {
-        outputs[entry->dst] += sources[entry->src] * (entry->rate * 0.01f);
-      }
-    }
-    entry++;
-  }
+  sources[MIXER_SOURCE_THRUST] = thrust;
+  matrix.mixPassThrough(sources + MIXER_SOURCE_THRUST, outputs);
+
+  // shaped outputs are limited and checked for saturation
+  _curve.apply(outputs, count);
 
   bool saturated = false;
-  for(size_t i = 0; i < mixer.count; i++)
+  for(size_t i = 0; i < count; i++)
   {
     const OutputChannelConfig& occ = _model.config.output.channel[i];
     if(!occ.servo && outputs[i] >= 0.98f) saturated = true;
@@ -261,18 +255,9 @@ void FAST_CODE_ATTR Mixer::writeOutput(const MixerConfig& mixer, float * out)
     }
   }
 
-  for(size_t i = 0; i < OUTPUT_CHANNELS; i++)
-  {
-    const OutputChannelConfig& och = _model.config.output.channel[i];
-    if(och.servo)
-    {
-      if(_servo) _servo->write(i, _model.state.outputUs[i]);
-    }
-    else
-    {
-      if(_motor) _motor->write(i, _model.state.outputUs[i]);
-    }
-  }
+  // each driver transmits only channels attached to it
+  if(_motor) _motor->writeAll(_model.state.outputUs, OUTPUT_CHANNELS);
+  if(_servo) _servo->writeAll(_model.state.outputUs, OUTPUT_CHANNELS);
 
   if(_motor) _motor->apply();
   if(_servo) _servo->apply();
@@ -360,6 +345,19 @@ void FAST_CODE_ATTR Mixer::readTelemetry()
     }
     _statsCounter = 0;
   }
+
+  TelemetrySnapshot snapshot;
+  std::copy_n(_model.state.outputTelemetryRpm, OUTPUT_CHANNELS, snapshot.rpm);
+  std::copy_n(_model.state.outputTelemetryErrors, OUTPUT_CHANNELS, snapshot.errors);
+  std::copy_n(_model.state.outputTelemetryTemperature, OUTPUT_CHANNELS, snapshot.temperature);
+  std::copy_n(_model.state.outputTelemetryVoltage, OUTPUT_CHANNELS, snapshot.voltage);
+  std::copy_n(_model.state.outputTelemetryCurrent, OUTPUT_CHANNELS, snapshot.current);
+#if defined(ESPFC_MULTI_CORE)
+  // outputTelemetrySampled belongs to serial task, msp takes coherent copy
+  _model.state.outputTelemetrySample.write(snapshot);
+#else
+  _model.state.outputTelemetrySampled = snapshot;
+#endif
 }
 
 float inline Mixer::erpmToHz(float erpm)
@@ -375,7 +373,7 @@ float inline Mixer::erpmToRpm(float erpm)
 bool Mixer::_stop(void)
 {
   if(!_model.isActive(MODE_ARMED)) return true;
-  if(_model.isActive(FEATURE_MOTOR_STOP) && _model.isThrottleLow()) return true;
+  if(_model.isActive(FEATURE_MOTOR_STOP) && _model.isThrottleLow(_model.state.inputSampled.inputUs)) return true;
   return false;
 }
 
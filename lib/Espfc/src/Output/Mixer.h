@@ -2,6 +2,8 @@
 
 #include "Model.h"
 #include "EscDriver.h"
+#include "Output/MixerMatrix.h"
+#include "Output/OutputCurve.h"
 
 namespace Espfc {
 
@@ -13,8 +15,10 @@ class Mixer
     Mixer(Model& model);
     int begin();
     int update();
+    // rebuilds output curve tables after battery voltage update, outside of mixer loop
+    void updateCurve();
 
-    void updateMixer(const MixerConfig& mixer, float * outputs);
+    void updateMixer(const MixerMatrix& matrix, float * outputs);
     float limitThrust(float thrust, ThrottleLimitType type, int8_t limit);
     float limitOutput(float output, const OutputChannelConfig& occ, int limit);
     void writeOutput(const MixerConfig& mixer, float * out);
@@ -30,6 +34,8 @@ class Mixer
 
     EscDriver escMotor;
     EscDriver escServo;
+    MixerMatrix _matrix;
+    OutputCurve _curve;
     uint32_t _statsCounter;
     uint32_t _statsCounterMax;
     float _erpmToHz;
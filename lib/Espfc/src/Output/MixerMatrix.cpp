@@ -0,0 +1,113 @@
+#include <algorithm>
+#include "MixerMatrix.h"
+#include "Math/FixedPoint.h"
+#include "Utils/MemoryHelper.h"
+
+namespace Espfc {
+
+namespace Output {
+
+MixerMatrix::MixerMatrix(): _count(0), _passCount(0) {}
+
+void MixerMatrix::compile(const MixerConfig& mixer)
+{
+  _count = mixer.count > 0 ? std::min((size_t)mixer.count, OUTPUT_CHANNELS) : 0;
+  for(size_t i = 0; i < OUTPUT_CHANNELS; i++)
+  {
+    for(size_t j = 0; j < STABILIZED; j++) _stabilizedRate[i][j] = 0;
+    for(size_t j = 0; j < PASS; j++) _passRate[i][j] = 0;
+  }
+
+  bool used[PASS] = { false };
+  for(size_t k = 0; mixer.mixes && k < MIXER_RULE_MAX; k++)
+  {
+    const MixerEntry& entry = mixer.mixes[k];
+    if(entry.src == MIXER_SOURCE_NULL) break; // break on terminator
+    if(entry.src < 0 || entry.src >= MIXER_SOURCE_MAX) continue;
+    if(entry.dst < 0 || (size_t)entry.dst >= _count || entry.rate == 0) continue;
+
+#if defined(ESPFC_FIXED_POINT)
+    const Rate rate = Math::toQ20(entry.rate * 0.01f);
+#else
+    const Rate rate = entry.rate * 0.01f;
+#endif
+    if(entry.src < MIXER_SOURCE_THRUST)
+    {
+      _stabilizedRate[entry.dst][entry.src - MIXER_SOURCE_ROLL] += rate;
+    }
+    else
+    {
+      _passRate[entry.dst][entry.src - MIXER_SOURCE_THRUST] += rate;
+      used[entry.src - MIXER_SOURCE_THRUST] = true;
+    }
+  }
+
+  _passCount = 0;
+  for(size_t j = 0; j < PASS; j++)
+  {
+    if(used[j]) _pass[_passCount++] = j;
+  }
+}
+
+#if defined(ESPFC_FIXED_POINT)
+
+void FAST_CODE_ATTR MixerMatrix::mixStabilized(const float * rpy, float * outputs) const
+{
+  const int32_t r = Math::toQ16(rpy[0]);
+  const int32_t p = Math::toQ16(rpy[1]);
+  const int32_t y = Math::toQ16(rpy[2]);
+  for(size_t i = 0; i < _count; i++)
+  {
+    const Rate * m = _stabilizedRate[i];
+    const int64_t acc = (int64_t)m[0] * r + (int64_t)m[1] * p + (int64_t)m[2] * y;
+    outputs[i] = Math::fromQ16(Math::roundFixed<Math::Q20_BITS>(acc));
+  }
+}
+
+void FAST_CODE_ATTR MixerMatrix::mixPassThrough(const float * sources, float * outputs) const
+{
+  int32_t v[PASS];
+  for(size_t k = 0; k < _passCount; k++)
+  {
+    v[k] = Math::toQ16(sources[_pass[k]]);
+  }
+  for(size_t i = 0; i < _count; i++)
+  {
+    int64_t acc = 0;
+    for(size_t k = 0; k < _passCount; k++)
+    {
+      acc += (int64_t)_passRate[i][_pass[k]] * v[k];
+    }
+    outputs[i] += Math::fromQ16(Math::roundFixed<Math::Q20_BITS>(acc));
+  }
+}
+
+#else
+
+void FAST_CODE_ATTR MixerMatrix::mixStabilized(const float * rpy, float * outputs) const
+{
+  for(size_t i = 0; i < _count; i++)
+  {
+    const float * m = _stabilizedRate[i];
+    outputs[i] = m[0] * rpy[0] + m[1] * rpy[1] + m[2] * rpy[2];
+  }
+}
+
+void FAST_CODE_ATTR MixerMatrix::mixPassThrough(const float * sources, float * outputs) const
+{
+  for(size_t k = 0; k < _passCount; k++)
+  {
+    const size_t j = _pass[k];
+    const float v = sources[j];
+    for(size_t i = 0; i < _count; i++)
+    {
+      outputs[i] += _passRate[i][j] * v;
+    }
+  }
+}
+
+#endif
+
+}
+
+}
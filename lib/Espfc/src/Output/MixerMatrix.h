@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include "ModelConfig.h"
+
+namespace Espfc {
+
+namespace Output {
+
+/**
+ * Mixer rules compiled to dense coefficient matrix, one row per output.
+ * Stabilized part takes roll, pitch and yaw, pass-through part takes thrust, rc and aux sources.
+ * Pass-through columns without any rule are skipped, invalid rules are dropped at compile time.
+ * With ESPFC_FIXED_POINT rates are kept in q20 and each output is accumulated in integers,
+ * sources are converted to q16 once and each output is converted back once.
+ */
+class MixerMatrix
+{
+  public:
+    static constexpr size_t STABILIZED = MIXER_SOURCE_THRUST - MIXER_SOURCE_ROLL;
+    static constexpr size_t PASS = MIXER_SOURCE_MAX - MIXER_SOURCE_THRUST;
+    static_assert(STABILIZED == 3, "roll, pitch and yaw expected before thrust");
+
+    MixerMatrix();
+
+    void compile(const MixerConfig& mixer);
+
+    // rpy indexed from MIXER_SOURCE_ROLL, overwrites outputs
+    void mixStabilized(const float * rpy, float * outputs) const;
+
+    // sources indexed from MIXER_SOURCE_THRUST, adds to outputs
+    void mixPassThrough(const float * sources, float * outputs) const;
+
+    size_t count() const { return _count; }
+
+  private:
+    size_t _count;
+    size_t _passCount;
+    uint8_t _pass[PASS];
+#if defined(ESPFC_FIXED_POINT)
+    typedef int32_t Rate; // q20
+#else
+    typedef float Rate;
+#endif
+    Rate _stabilizedRate[OUTPUT_CHANNELS][STABILIZED];
+    Rate _passRate[OUTPUT_CHANNELS][PASS];
+};
+
+}
+
+}
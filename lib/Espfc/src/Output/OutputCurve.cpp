@@ -0,0 +1,93 @@
+#include <cmath>
+#include <algorithm>
+#include "OutputCurve.h"
+#include "Math/Utils.h"
+#include "Utils/MemoryHelper.h"
+
+namespace Espfc {
+
+namespace Output {
+
+OutputCurve::OutputCurve(): _config(nullptr), _active(false), _cellVoltage(CELL_FULL), _voltage(CELL_FULL), _thrustLinear(0.f), _sagCompensation(0.f), _front(0) {}
+
+void OutputCurve::begin(const OutputConfig& config, float cellVoltage)
+{
+  _config = &config;
+  _thrustLinear = Math::clamp((int)config.thrustLinear, 0, 100) * 0.01f;
+  _sagCompensation = Math::clamp((int)config.vbatSagCompensation, 0, 100) * 0.01f;
+  _cellVoltage = _voltage = cellVoltage;
+
+  _active = _thrustLinear > 0.f || _sagCompensation > 0.f;
+  for(size_t i = 0; i < OUTPUT_CHANNELS; i++)
+  {
+    _motor[i] = !config.channel[i].servo;
+    if(_motor[i] && config.motorScale[i] != 100) _active = true;
+  }
+
+  build();
+}
+
+bool OutputCurve::update(float cellVoltage)
+{
+  if(!_active || _sagCompensation == 0.f) return false;
+  // battery connected after boot
+  if(_voltage < 2.0f) _voltage = cellVoltage;
+  _voltage += (cellVoltage - _voltage) * VOLTAGE_SMOOTHING;
+  if(std::abs(_voltage - _cellVoltage) < VOLTAGE_STEP) return false;
+  _cellVoltage = _voltage;
+  build();
+  return true;
+}
+
+void FAST_CODE_ATTR OutputCurve::apply(float * outputs, size_t count) const
+{
+  if(!_active) return;
+  if(count > OUTPUT_CHANNELS) count = OUTPUT_CHANNELS;
+  const uint8_t front = _front.load(std::memory_order_acquire);
+  for(size_t i = 0; i < count; i++)
+  {
+    if(!_motor[i]) continue;
+    const float pos = (Math::clamp(outputs[i], -1.f, 1.f) + 1.f) * (SIZE * 0.5f);
+    const size_t idx = std::min((size_t)pos, SIZE - 1);
+    const float * t = _table[front][i] + idx;
+    outputs[i] = t[0] + (t[1] - t[0]) * (pos - idx);
+  }
+}
+
+float OutputCurve::getExact(size_t channel, float output) const
+{
+  // motor thrust domain [0, 1], -1 is idle
+  float x = (Math::clamp(output, -1.f, 1.f) + 1.f) * 0.5f;
+  const float r = 1.f - x;
+  x *= 1.f + _thrustLinear * r * r;
+  x *= sagFactor();
+  x *= Math::clamp((int)_config->motorScale[channel], 50, 100) * 0.01f;
+  return Math::clamp(x, 0.f, 1.f) * 2.f - 1.f;
+}
+
+float OutputCurve::sagFactor() const
+{
+  // no battery connected
+  if(_sagCompensation == 0.f || _cellVoltage < 2.0f) return 1.f;
+  const float ratio = CELL_FULL / Math::clamp(_cellVoltage, CELL_EMPTY, CELL_FULL);
+  return 1.f + (ratio - 1.f) * _sagCompensation;
+}
+
+void OutputCurve::build()
+{
+  if(!_active) return;
+  const uint8_t back = _front.load(std::memory_order_relaxed) ^ 1;
+  for(size_t i = 0; i < OUTPUT_CHANNELS; i++)
+  {
+    if(!_motor[i]) continue;
+    for(size_t k = 0; k <= SIZE; k++)
+    {
+      _table[back][i][k] = getExact(i, k * 2.f / SIZE - 1.f);
+    }
+  }
+  _front.store(back, std::memory_order_release);
+}
+
+}
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include "ModelConfig.h"
+
+// motor output curve table segments per channel
+#ifndef ESPFC_OUTPUT_CURVE_SIZE
+#define ESPFC_OUTPUT_CURVE_SIZE 32
+#endif
+
+namespace Espfc {
+
+namespace Output {
+
+/**
+ * Motor output shaping, thrust linearization, battery sag compensation and per motor scale.
+ * Curves are evaluated into per motor tables at begin() and when smoothed cell voltage moves by more than VOLTAGE_STEP,
+ * apply() interpolates linearly between entries, servo channels are passed through.
+ * Tables are double buffered, update() runs from battery task and rebuilds back copy, then swaps it in,
+ * so apply() in mixer never waits for rebuild, also when it runs on other core.
+ */
+class OutputCurve
+{
+  public:
+    static constexpr size_t SIZE = ESPFC_OUTPUT_CURVE_SIZE;
+    static_assert(SIZE >= 2, "output curve table too small");
+
+    // cell voltage change [V] that triggers table rebuild
+    static constexpr float VOLTAGE_STEP = 0.05f;
+    // smoothing of cell voltage per update(), ~0.5s at 100Hz battery rate, throttle sag doesn't cause rebuilds
+    static constexpr float VOLTAGE_SMOOTHING = 0.02f;
+    // full and lowest compensated cell voltage [V]
+    static constexpr float CELL_FULL = 4.2f;
+    static constexpr float CELL_EMPTY = 3.3f;
+
+    OutputCurve();
+
+    void begin(const OutputConfig& config, float cellVoltage);
+
+    // smooths voltage and rebuilds tables if it moved enough, returns true if rebuilt
+    bool update(float cellVoltage);
+
+    // outputs in range [-1, 1], count is number of mixer outputs
+    void apply(float * outputs, size_t count) const;
+
+    // curve evaluation for motor channel, used to build tables
+    float getExact(size_t channel, float output) const;
+
+    bool active() const { return _active; }
+
+  private:
+    void build();
+    float sagFactor() const;
+
+    const OutputConfig * _config;
+    bool _active;
+    bool _motor[OUTPUT_CHANNELS];
+    float _cellVoltage;
+    float _voltage;
+    float _thrustLinear;
+    float _sagCompensation;
+    std::atomic<uint8_t> _front;
+    float _table[2][OUTPUT_CHANNELS][SIZE + 1];
+};
+
+}
+
+}
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include "RpmFilter.h"
+#include "Filter.h"
+#include "Math/Utils.h"
+#include "Math/SinCos.h"
+#include "Math/FixedPoint.h"
+#include "Utils/MemoryHelper.h"
+
+namespace Espfc {
+
+RpmFilter::RpmFilter(): _rate(0), _omegaScale(0.f), _q(0.f), _alphaScale(0.f), _harmonics(0), _count(0)
+{
+  begin(0, 0);
+}
+
+void RpmFilter::begin(int rate, size_t harmonics, size_t ramp)
+{
+  _rate = rate;
+  _omegaScale = rate > 0 ? 2.0f * Math::pi() / rate : 0.f;
+  _harmonics = harmonics < HARMONICS ? harmonics : HARMONICS;
+  _count = MOTORS * _harmonics;
+  _rampSteps = std::min(ramp, (size_t)UINT16_MAX);
+  _rampInv = _rampSteps > 0 ? 1.f / _rampSteps : 0.f;
+  _ramping = 0;
+  for(size_t i = 0; i < STAGES; i++)
+  {
+    _target[i] = Coefs{1.f, 0.f, 0.f, 0.f};
+    setCoefs(i, _target[i]);
+    _delta[i] = Coefs{0.f, 0.f, 0.f, 0.f};
+    _rampLeft[i] = 0;
+  }
+  reset();
+}
+
+void RpmFilter::reset()
+{
+  for(size_t i = 0; i < STAGES; i++)
+  {
+    for(size_t j = 0; j < AXES; j++)
+    {
+      _state[i][j] = State{0, 0, 0, 0};
+    }
+  }
+}
+
+void FAST_CODE_ATTR RpmFilter::reconfigure(size_t motor, size_t harmonic, float freq, float q, float weight)
+{
+  if(motor >= MOTORS || harmonic >= _harmonics) return;
+
+  const size_t i = motor * _harmonics + harmonic;
+  Coefs t = _rampLeft[i] ? _target[i] : _coefs[i];
+  t.w = Math::clamp(weight, 0.f, 1.f);
+  if(freq <= 0.f || q <= 0.f || _rate <= 0)
+  {
+    t.w = 0.f;
+  }
+  else
+  {
+    // q rarely changes, keep its reciprocal
+    if(q != _q)
+    {
+      _q = q;
+      _alphaScale = 0.5f / q;
+    }
+
+    float sn, cs;
+    Math::sinCos(std::min(freq, _rate * 0.49f) * _omegaScale, sn, cs);
+    const float alpha = sn * _alphaScale;
+    const float a0inv = 1.f / (1.f + alpha);
+    t.b0 = a0inv;
+    t.a1 = -2.f * cs * a0inv;
+    t.a2 = (1.f - alpha) * a0inv;
+  }
+
+  if(!_rampSteps)
+  {
+    setCoefs(i, t);
+    return;
+  }
+
+  // start from current coefficients, even if previous ramp is not finished yet
+  const Coefs& c = _coefs[i];
+  _target[i] = t;
+  _delta[i] = Coefs{(t.b0 - c.b0) * _rampInv, (t.a1 - c.a1) * _rampInv, (t.a2 - c.a2) * _rampInv, (t.w - c.w) * _rampInv};
+  if(!_rampLeft[i]) _ramping++;
+  _rampLeft[i] = _rampSteps;
+}
+
+void FAST_CODE_ATTR RpmFilter::updateRamp()
+{
+  for(size_t i = 0; i < _count; i++)
+  {
+    if(!_rampLeft[i]) continue;
+    if(--_rampLeft[i] == 0)
+    {
+      // land exactly on target, no accumulated rounding
+      setCoefs(i, _target[i]);
+      _ramping--;
+      continue;
+    }
+    const Coefs& c = _coefs[i];
+    const Coefs& d = _delta[i];
+    setCoefs(i, Coefs{c.b0 + d.b0, c.a1 + d.a1, c.a2 + d.a2, c.w + d.w});
+  }
+}
+
+void FAST_CODE_ATTR RpmFilter::setCoefs(size_t i, const Coefs& c)
+{
+  _coefs[i] = c;
+#if defined(ESPFC_FIXED_POINT)
+  _fixed[i] = CoefsFixed{Math::toQ30(c.b0), Math::toQ30(c.a1), Math::toQ30(c.a2), Math::toQ30(c.w)};
+#endif
+}
+
+#if defined(ESPFC_FIXED_POINT)
+
+RpmFilter::Sample RpmFilter::apply(size_t i, State& s, Sample n)
+{
+  // y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2, where b2 = b0 and b1 = a1
+  const CoefsFixed& c = _fixed[i];
+  const int32_t r = Math::roundFixed<Math::Q30_BITS>((int64_t)c.b0 * ((int64_t)n + s.x2) + (int64_t)c.a1 * ((int64_t)s.x1 - s.y1) - (int64_t)c.a2 * s.y2);
+  s.x2 = s.x1; s.x1 = n;
+  s.y2 = s.y1; s.y1 = r;
+  return n + Math::mulQ30(r - n, c.w);
+}
+
+#else
+
+RpmFilter::Sample RpmFilter::apply(size_t i, State& s, Sample n)
+{
+  // y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2, where b2 = b0 and b1 = a1
+  const Coefs& c = _coefs[i];
+  const float r = c.b0 * (n + s.x2) + c.a1 * (s.x1 - s.y1) - c.a2 * s.y2;
+  s.x2 = s.x1; s.x1 = n;
+  s.y2 = s.y1; s.y1 = r;
+  return n + c.w * (r - n);
+}
+
+#endif
+
+float RpmFilter::getGroupDelay(float freq) const
+{
+  if(_rate <= 0) return 0.f;
+  const float omega = freq * _omegaScale;
+  float delay = 0.f;
+  for(size_t i = 0; i < _count; i++)
+  {
+    const Coefs& k = _coefs[i];
+    const float c[5] = { k.b0, k.a1, k.b0, k.a1, k.a2 };
+    delay += getFilterGroupDelay(FILTER_NOTCH_DF1, c, k.w, omega);
+  }
+  return delay / _rate;
+}
+
+VectorFloat FAST_CODE_ATTR RpmFilter::update(const VectorFloat& v)
+{
+  if(_ramping) updateRamp();
+
+#if defined(ESPFC_FIXED_POINT)
+  Sample x = Math::toQ16(v.x), y = Math::toQ16(v.y), z = Math::toQ16(v.z);
+#else
+  Sample x = v.x, y = v.y, z = v.z;
+#endif
+  for(size_t i = 0; i < _count; i++)
+  {
+    State * s = _state[i];
+    x = apply(i, s[0], x);
+    y = apply(i, s[1], y);
+    z = apply(i, s[2], z);
+  }
+#if defined(ESPFC_FIXED_POINT)
+  return VectorFloat(Math::fromQ16(x), Math::fromQ16(y), Math::fromQ16(z));
+#else
+  return VectorFloat(x, y, z);
+#endif
+}
+
+}
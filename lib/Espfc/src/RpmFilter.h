@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <helper_3dmath.h>
+
+namespace Espfc {
+
+/**
+ * Cascade of DF1 notch filters, one per motor and harmonic, applied to all three gyro axes.
+ * Coefficients are shared by axes and stored next to each other, so update() is one tight loop over stages.
+ * Notch symmetry (b2 = b0, b1 = a1) is used to store only b0, a1, a2 and weight per stage.
+ * Retune uses table based sin/cos, so all stages can be updated every loop.
+ * Optional ramp crossfades coefficients over a few samples, to avoid transients on retune.
+ * With ESPFC_FIXED_POINT stages run in Q16.16 with Q30 coefficients, samples are converted once per update,
+ * coefficients are retuned in float and mirrored to integer when they change.
+ */
+class RpmFilter
+{
+  public:
+    static constexpr size_t MOTORS = 4;
+    static constexpr size_t HARMONICS = 3;
+    static constexpr size_t STAGES = MOTORS * HARMONICS;
+    static constexpr size_t AXES = 3;
+
+    RpmFilter();
+    void begin(int rate, size_t harmonics, size_t ramp = 0);
+    VectorFloat update(const VectorFloat& v);
+    void reset();
+
+    // retune single stage, zero freq or weight turns stage into pass through
+    // with ramp enabled, coefficients move to new values linearly over ramp samples
+    void reconfigure(size_t motor, size_t harmonic, float freq, float q, float weight = 1.0f);
+
+    size_t stages() const { return _count; }
+    float getGroupDelay(float freq) const; // seconds, all stages
+
+  private:
+    struct Coefs
+    {
+      float b0, a1, a2, w;
+    };
+
+#if defined(ESPFC_FIXED_POINT)
+    typedef int32_t Sample;
+    struct CoefsFixed
+    {
+      int32_t b0, a1, a2, w;
+    };
+#else
+    typedef float Sample;
+#endif
+
+    struct State
+    {
+      Sample x1, x2, y1, y2;
+    };
+
+    inline Sample apply(size_t i, State& s, Sample n);
+    void updateRamp();
+    void setCoefs(size_t i, const Coefs& c);
+
+    int _rate;
+    float _omegaScale;
+    float _q;
+    float _alphaScale;
+    size_t _harmonics;
+    size_t _count;
+    Coefs _coefs[STAGES];
+#if defined(ESPFC_FIXED_POINT)
+    CoefsFixed _fixed[STAGES];
+#endif
+    State _state[STAGES][AXES];
+
+    // coefficient crossfade
+    size_t _rampSteps;
+    float _rampInv;
+    size_t _ramping;
+    uint16_t _rampLeft[STAGES];
+    Coefs _target[STAGES];
+    Coefs _delta[STAGES];
+};
+
+}
@@ -0,0 +1,199 @@
+#include <Arduino.h>
+#include "Scheduler.h"
+#include "Utils/MemoryHelper.h"
+
+namespace Espfc {
+
+namespace {
+
+uint32_t defaultClock()
+{
+  return micros();
+}
+
+uint32_t gcd(uint32_t a, uint32_t b)
+{
+  while(b)
+  {
+    const uint32_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+}
+
+Scheduler::Scheduler(): _clock(defaultClock), _period(0), _count(0), _cycles(1) {}
+
+void Scheduler::setClock(ClockFn clock)
+{
+  _clock = clock;
+}
+
+int Scheduler::add(const char * name, TaskFn fn, void * ctx, uint32_t denom, uint8_t priority, uint16_t budget, int slot)
+{
+  if(_count >= TASKS_MAX) return -1;
+  Task& t = _tasks[_count];
+  t = Task();
+  t.name = name;
+  t.fn = fn;
+  t.ctx = ctx;
+  t.denom = denom;
+  t.slot = slot > 0 ? slot : 0;
+  t.fixed = slot != SLOT_AUTO;
+  t.budget = budget;
+  t.priority = priority;
+  t.after = -1;
+  t.state = TASK_IDLE;
+  return _count++;
+}
+
+int Scheduler::follow(int id, const char * name, TaskFn fn, void * ctx, uint8_t priority, uint16_t budget)
+{
+  if(id < 0 || (size_t)id >= _count) return -1;
+  const int res = add(name, fn, ctx, _tasks[id].denom, priority, budget);
+  if(res >= 0) _tasks[res].after = id;
+  return res;
+}
+
+void Scheduler::begin(uint32_t period)
+{
+  _period = period;
+
+  // plan covers common multiple of rates, longer plans are approximated
+  _cycles = 1;
+  for(size_t i = 0; i < _count; i++)
+  {
+    const uint32_t denom = _tasks[i].denom;
+    if(!denom) continue;
+    const uint32_t cycles = _cycles / gcd(_cycles, denom) * denom;
+    if(cycles <= CYCLES_MAX) _cycles = cycles;
+  }
+
+  // execution order by priority, then registration
+  for(size_t i = 0; i < _count; i++)
+  {
+    size_t j = i;
+    for(; j > 0 && _tasks[_order[j - 1]].priority > _tasks[i].priority; j--) _order[j] = _order[j - 1];
+    _order[j] = i;
+  }
+
+  uint32_t load[CYCLES_MAX] = {0};
+  for(size_t i = 0; i < _count; i++)
+  {
+    Task& t = _tasks[i];
+    if(!t.denom || !t.fixed) continue;
+    t.slot %= t.denom;
+    for(size_t c = t.slot; c < _cycles; c += t.denom) load[c] += t.budget;
+  }
+
+  // important and expensive tasks pick slot first
+  uint8_t queue[TASKS_MAX];
+  size_t n = 0;
+  for(size_t i = 0; i < _count; i++)
+  {
+    const Task& t = _tasks[_order[i]];
+    if(!t.denom || t.fixed || t.after >= 0) continue;
+    size_t j = n++;
+    for(; j > 0 && _tasks[queue[j - 1]].priority == t.priority && _tasks[queue[j - 1]].budget < t.budget; j--) queue[j] = queue[j - 1];
+    queue[j] = _order[i];
+  }
+  for(size_t i = 0; i < n; i++) place(_tasks[queue[i]], load);
+
+  for(size_t i = 0; i < _count; i++)
+  {
+    Task& t = _tasks[i];
+    if(!t.denom || t.after < 0) continue;
+    t.slot = (_tasks[t.after].slot + 1) % t.denom;
+    for(size_t c = t.slot; c < _cycles; c += t.denom) load[c] += t.budget;
+  }
+
+  resetStats();
+}
+
+void Scheduler::place(Task& t, uint32_t * load)
+{
+  // slot with lowest peak load, then lowest total
+  uint32_t bestPeak = UINT32_MAX, bestSum = UINT32_MAX;
+  const size_t slots = t.denom < _cycles ? t.denom : _cycles;
+  for(size_t s = 0; s < slots; s++)
+  {
+    uint32_t peak = 0, sum = 0;
+    for(size_t c = s; c < _cycles; c += t.denom)
+    {
+      if(load[c] > peak) peak = load[c];
+      sum += load[c];
+    }
+    if(peak < bestPeak || (peak == bestPeak && sum < bestSum))
+    {
+      bestPeak = peak;
+      bestSum = sum;
+      t.slot = s;
+    }
+  }
+  for(size_t c = t.slot; c < _cycles; c += t.denom) load[c] += t.budget;
+}
+
+void FAST_CODE_ATTR Scheduler::run(uint32_t cycle)
+{
+  const uint32_t start = _clock();
+  for(size_t i = 0; i < _count; i++)
+  {
+    Task& t = _tasks[_order[i]];
+    if(due(t, cycle))
+    {
+      if(t.state == TASK_IDLE)
+      {
+        t.state = TASK_PENDING;
+      }
+      else
+      {
+        t.misses++;
+        t.state = TASK_OVERDUE;
+      }
+    }
+    if(t.state == TASK_IDLE) continue;
+
+    const uint32_t now = _clock();
+    if(t.priority && t.state == TASK_PENDING && now - start + t.budget > _period)
+    {
+      t.deferrals++;
+      continue;
+    }
+
+    t.fn(t.ctx);
+
+    const uint32_t time = _clock() - now;
+    t.state = TASK_IDLE;
+    t.runs++;
+    if(time > t.budget) t.overruns++;
+    if(time > t.maxTime) t.maxTime = time;
+  }
+}
+
+void Scheduler::resetStats()
+{
+  for(size_t i = 0; i < _count; i++)
+  {
+    Task& t = _tasks[i];
+    t.state = TASK_IDLE;
+    t.runs = 0;
+    t.overruns = 0;
+    t.deferrals = 0;
+    t.misses = 0;
+    t.maxTime = 0;
+  }
+}
+
+uint32_t Scheduler::plannedLoad(uint32_t cycle) const
+{
+  uint32_t sum = 0;
+  for(size_t i = 0; i < _count; i++)
+  {
+    if(due(_tasks[i], cycle)) sum += _tasks[i].budget;
+  }
+  return sum;
+}
+
+}
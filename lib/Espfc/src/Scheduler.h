@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Espfc {
+
+/**
+ * Static scheduler of tasks synchronized to gyro cycle.
+ * Task runs every denom cycles in its slot (cycle % denom == slot), tasks without fixed slot
+ * are placed in begin() so declared budgets are spread evenly over cycles.
+ * Critical tasks (priority 0) always run when due, others are deferred to next cycle
+ * when budget does not fit into rest of the period, and forced when due again.
+ * Time is read through clock function, so plans can be tested against virtual clock.
+ */
+class Scheduler
+{
+  public:
+    typedef uint32_t (*ClockFn)();
+    typedef void (*TaskFn)(void * ctx);
+
+    static constexpr size_t TASKS_MAX = 16;
+    static constexpr size_t CYCLES_MAX = 64;
+    static constexpr int SLOT_AUTO = -1;
+
+    enum TaskState : uint8_t
+    {
+      TASK_IDLE,
+      TASK_PENDING,
+      TASK_OVERDUE,
+    };
+
+    struct Task
+    {
+      const char * name;
+      TaskFn fn;
+      void * ctx;
+      uint16_t denom;   // 0 disables task
+      uint16_t slot;
+      uint16_t budget;  // us
+      uint8_t priority; // 0 is critical
+      int8_t after;     // task id, runs one cycle after it
+      bool fixed;
+      TaskState state;
+
+      uint32_t runs;
+      uint32_t overruns;  // took longer than budget
+      uint32_t deferrals; // postponed to next cycle
+      uint32_t misses;    // due again before it could run
+      uint32_t maxTime;
+    };
+
+    Scheduler();
+
+    void setClock(ClockFn clock);
+
+    // returns task id or -1 if there is no space
+    int add(const char * name, TaskFn fn, void * ctx, uint32_t denom, uint8_t priority, uint16_t budget, int slot = SLOT_AUTO);
+    // same rate as task id, one cycle later
+    int follow(int id, const char * name, TaskFn fn, void * ctx, uint8_t priority, uint16_t budget);
+
+    // period [us] is time available in one cycle
+    void begin(uint32_t period);
+    void run(uint32_t cycle);
+    void resetStats();
+
+    // sum of budgets planned for cycle
+    uint32_t plannedLoad(uint32_t cycle) const;
+
+    size_t count() const { return _count; }
+    size_t cycles() const { return _cycles; }
+    uint32_t period() const { return _period; }
+    const Task& task(size_t id) const { return _tasks[id]; }
+
+  private:
+    void place(Task& t, uint32_t * load);
+    bool due(const Task& t, uint32_t cycle) const { return t.denom && cycle % t.denom == t.slot; }
+
+    ClockFn _clock;
+    uint32_t _period;
+    size_t _count;
+    size_t _cycles;
+    Task _tasks[TASKS_MAX];
+    uint8_t _order[TASKS_MAX];
+};
+
+}
@@ -1,6 +1,6 @@
 
 #include "GyroSensor.h"
-#include "Utils/FilterHelper.h"
+#include "FilterChain.h"
 
 #define ESPFC_FUZZY_ACCEL_ZERO 0.05
 #define ESPFC_FUZZY_GYRO_ZERO 0.20
@@ -10,6 +10,65 @@ namespace Espfc
 namespace Sensor
 {
 
+namespace {
+
+// optional stages of gyro filter chain, in processing order
+enum GyroChainStage {
+  GYRO_CHAIN_LPF2,
+  GYRO_CHAIN_RPM,
+  GYRO_CHAIN_NOTCH1,
+  GYRO_CHAIN_NOTCH2,
+  GYRO_CHAIN_LPF1,
+  GYRO_CHAIN_COUNT,
+};
+
+struct GyroLpf2Stage
+{
+  static inline void apply(Model& m, VectorFloat& v) { v = m.state.gyroFilter2.update(v); }
+};
+
+struct GyroRpmStage
+{
+  static inline void apply(Model& m, VectorFloat& v) { v = m.state.rpmFilter.update(v); }
+};
+
+struct GyroNotch1Stage
+{
+  static inline void apply(Model& m, VectorFloat& v) { v = m.state.gyroNotch1Filter.update(v); }
+};
+
+struct GyroNotch2Stage
+{
+  static inline void apply(Model& m, VectorFloat& v) { v = m.state.gyroNotch2Filter.update(v); }
+};
+
+struct GyroLpf1Stage
+{
+  static inline void apply(Model& m, VectorFloat& v) { v = m.state.gyroFilter.update(v); }
+};
+
+template<size_t index>
+struct GyroDebugStage
+{
+  static inline void apply(Model& m, VectorFloat& v) { m.setDebug(DEBUG_GYRO_SAMPLE, index, lrintf(degrees(v[m.config.debugAxis]))); }
+};
+
+template<size_t mask>
+using GyroChain = FilterChain<Model, VectorFloat,
+  FilterStageIf<(mask & (1 << GYRO_CHAIN_LPF2)) != 0, GyroLpf2Stage>,
+  GyroDebugStage<1>,
+  FilterStageIf<(mask & (1 << GYRO_CHAIN_RPM)) != 0, GyroRpmStage>,
+  GyroDebugStage<2>,
+  FilterStageIf<(mask & (1 << GYRO_CHAIN_NOTCH1)) != 0, GyroNotch1Stage>,
+  FilterStageIf<(mask & (1 << GYRO_CHAIN_NOTCH2)) != 0, GyroNotch2Stage>,
+  FilterStageIf<(mask & (1 << GYRO_CHAIN_LPF1)) != 0, GyroLpf1Stage>,
+  GyroDebugStage<3>
+>;
+
+typedef FilterChainSelector<Model, VectorFloat, GyroChain, GYRO_CHAIN_COUNT> GyroChainSelector;
+
+}
+
 GyroSensor::GyroSensor(Model &model) : _dyn_notch_denom(1), _model(model)
 {
 }
@@ -34,7 +93,6 @@ int GyroSensor::begin()
   _dyn_notch_debug = _model.config.debugMode == DEBUG_FFT_FREQ || _model.config.debugMode == DEBUG_FFT_TIME;
 
   _rpm_enabled = _model.config.rpmFilterHarmonics > 0 && _model.config.output.dshotTelemetry;
-  _rpm_motor_index = 0;
   _rpm_fade_inv = 1.0f / _model.config.rpmFilterFade;
   _rpm_min_freq = _model.config.rpmFilterMinFreq;
   _rpm_max_freq = 0.48f * _model.state.loopTimer.rate;
@@ -46,7 +104,7 @@ int GyroSensor::begin()
   }
   for (size_t i = 0; i < 3; i++)
   {
-#ifdef ESPFC_DSP
+#if defined(ESPFC_FFT) || defined(ESPFC_SDFT)
     _fft[i].begin(_model.state.loopTimer.rate / _dyn_notch_denom, _model.config.dynamicFilter, i);
 #else
     _freqAnalyzer[i].begin(_model.state.loopTimer.rate / _dyn_notch_denom, _model.config.dynamicFilter);
@@ -71,15 +129,23 @@ int FAST_CODE_ATTR GyroSensor::read()
   align(input, _model.config.gyroAlign);
   input = _model.state.boardAlignment.apply(input);
 
+  VectorFloat sample;
   if (_model.config.gyroFilter3.freq)
   {
-    _model.state.gyroSampled = Utils::applyFilter(_model.state.gyroFilter3, input);
+    sample = _model.state.gyroFilter3.update(input);
   }
   else
   {
-    _model.state.gyroSampled = _sma.update(input);
+    sample = _sma.update(input);
   }
 
+#if defined(ESPFC_MULTI_CORE)
+  // gyroSampled belongs to pid task, it takes coherent copy in filter()
+  _model.state.gyroSample.write(GyroSample{sample, (uint32_t)micros()});
+#else
+  _model.state.gyroSampled = sample;
+#endif
+
   return 1;
 }
 
@@ -89,6 +155,16 @@ int FAST_CODE_ATTR GyroSensor::filter()
 
   Stats::Measure measure(_model.state.stats, COUNTER_GYRO_FILTER);
 
+#if defined(ESPFC_MULTI_CORE)
+  GyroSample sample;
+  if (_model.state.gyroSample.receive(sample))
+  {
+    _model.state.gyroSampled = sample.gyro;
+    // latency from gyro read to pid task
+    _model.state.stats.addMicros(COUNTER_WAKEUP, micros() - sample.timestamp);
+  }
+#endif
+
   _model.state.gyro = _model.state.gyroSampled;
 
   calibrate();
@@ -103,28 +179,14 @@ int FAST_CODE_ATTR GyroSensor::filter()
 
   _model.setDebug(DEBUG_GYRO_SAMPLE, 0, lrintf(degrees(_model.state.gyro[_model.config.debugAxis])));
 
-  _model.state.gyro = Utils::applyFilter(_model.state.gyroFilter2, _model.state.gyro);
-
-  _model.setDebug(DEBUG_GYRO_SAMPLE, 1, lrintf(degrees(_model.state.gyro[_model.config.debugAxis])));
-
-  if (_rpm_enabled)
-  {
-    for (size_t m = 0; m < RPM_FILTER_MOTOR_MAX; m++)
-    {
-      for (size_t n = 0; n < _model.config.rpmFilterHarmonics; n++)
-      {
-        _model.state.gyro = Utils::applyFilter(_model.state.rpmFilter[m][n], _model.state.gyro);
-      }
-    }
-  }
-
-  _model.setDebug(DEBUG_GYRO_SAMPLE, 2, lrintf(degrees(_model.state.gyro[_model.config.debugAxis])));
-
-  _model.state.gyro = Utils::applyFilter(_model.state.gyroNotch1Filter, _model.state.gyro);
-  _model.state.gyro = Utils::applyFilter(_model.state.gyroNotch2Filter, _model.state.gyro);
-  _model.state.gyro = Utils::applyFilter(_model.state.gyroFilter, _model.state.gyro);
-
-  _model.setDebug(DEBUG_GYRO_SAMPLE, 3, lrintf(degrees(_model.state.gyro[_model.config.debugAxis])));
+  // disabled stages are not instantiated, mask is evaluated every time as Model::reload() may reconfigure filters
+  size_t mask = 0;
+  if (_model.state.gyroFilter2.type() != FILTER_NONE) mask |= 1 << GYRO_CHAIN_LPF2;
+  if (_rpm_enabled) mask |= 1 << GYRO_CHAIN_RPM;
+  if (_model.state.gyroNotch1Filter.type() != FILTER_NONE) mask |= 1 << GYRO_CHAIN_NOTCH1;
+  if (_model.state.gyroNotch2Filter.type() != FILTER_NONE) mask |= 1 << GYRO_CHAIN_NOTCH2;
+  if (_model.state.gyroFilter.type() != FILTER_NONE) mask |= 1 << GYRO_CHAIN_LPF1;
+  GyroChainSelector::select(mask)(_model, _model.state.gyro);
 
   if (_dyn_notch_enabled || _dyn_notch_debug)
   {
@@ -135,7 +197,7 @@ int FAST_CODE_ATTR GyroSensor::filter()
   {
     for (size_t p = 0; p < (size_t)_model.config.dynamicFilter.width; p++)
     {
-      _model.state.gyro = Utils::applyFilter(_model.state.gyroDynNotchFilter[p], _model.state.gyro);
+      _model.state.gyro = _model.state.gyroDynNotchFilter[p].update(_model.state.gyro);
     }
   }
 
@@ -146,7 +208,7 @@ int FAST_CODE_ATTR GyroSensor::filter()
 
   if (_model.accelActive())
   {
-    _model.state.gyroImu = Utils::applyFilter(_model.state.gyroImuFilter, _model.state.gyro);
+    _model.state.gyroImu = _model.state.gyroImuFilter.update(_model.state.gyro);
   }
 
   return 1;
@@ -164,30 +226,23 @@ void FAST_CODE_ATTR GyroSensor::rpmFilterUpdate()
 
   Stats::Measure measure(_model.state.stats, COUNTER_RPM_UPDATE);
 
-  const float motorFreq = _model.state.outputTelemetryFreq[_rpm_motor_index];
-  for (size_t n = 0; n < _model.config.rpmFilterHarmonics; n++)
+  // coefficients are cheap to compute, so all motors are retuned every loop
+  for (size_t m = 0; m < RPM_FILTER_MOTOR_MAX; m++)
   {
-    const float freq = Math::clamp(motorFreq * (n + 1), _rpm_min_freq, _rpm_max_freq);
-    const float freqMargin = freq - _rpm_min_freq;
-    float weight = _rpm_weights[n];
-    if (freqMargin < _model.config.rpmFilterFade)
-    {
-      weight *= freqMargin * _rpm_fade_inv;
-    }
-    _model.state.rpmFilter[_rpm_motor_index][n][0].reconfigure(freq, freq, _rpm_q, weight);
-    for (size_t i = 1; i < 3; ++i)
+    const float motorFreq = _model.state.outputTelemetryFreq[m];
+    for (size_t n = 0; n < _model.config.rpmFilterHarmonics; n++)
     {
-      // copy coefs from roll to pitch and yaw
-      _model.state.rpmFilter[_rpm_motor_index][n][i].reconfigure(_model.state.rpmFilter[_rpm_motor_index][n][0]);
+      const float freq = Math::clamp(motorFreq * (n + 1), _rpm_min_freq, _rpm_max_freq);
+      const float freqMargin = freq - _rpm_min_freq;
+      float weight = _rpm_weights[n];
+      if (freqMargin < _model.config.rpmFilterFade)
+      {
+        weight *= freqMargin * _rpm_fade_inv;
+      }
+      _model.state.rpmFilter.reconfigure(m, n, freq, _rpm_q, weight);
     }
-  }
 
-  _model.setDebug(DEBUG_RPM_FILTER, _rpm_motor_index, lrintf(_model.state.outputTelemetryFreq[_rpm_motor_index]));
-
-  _rpm_motor_index++;
-  if (_rpm_motor_index >= RPM_FILTER_MOTOR_MAX)
-  {
-    _rpm_motor_index = 0;
+    _model.setDebug(DEBUG_RPM_FILTER, m, lrintf(motorFreq));
   }
 }
 
@@ -206,7 +261,7 @@ void FAST_CODE_ATTR GyroSensor::dynNotchFilterUpdate()
 
     for (size_t i = 0; i < 3; ++i)
     {
-#ifdef ESPFC_DSP
+#if defined(ESPFC_FFT) || defined(ESPFC_SDFT)
       (void)update;
       if (feed)
       {
@@ -232,7 +287,7 @@ void FAST_CODE_ATTR GyroSensor::dynNotchFilterUpdate()
             float freq = _fft[i].peaks[p].freq;
             if (freq >= _model.config.dynamicFilter.min_freq && freq <= _model.config.dynamicFilter.max_freq)
             {
-              _model.state.gyroDynNotchFilter[p][i].reconfigure(freq, freq, q);
+              _model.state.gyroDynNotchFilter[p].reconfigureAxis(i, freq, freq, q);
             }
           }
         }
@@ -265,7 +320,7 @@ void FAST_CODE_ATTR GyroSensor::dynNotchFilterUpdate()
               size_t x = (p + i) % 3;
               int harmonic = (p / 3) + 1;
               int16_t f = Math::clamp((int16_t)lrintf(freq * harmonic), _model.config.dynamicFilter.min_freq, _model.config.dynamicFilter.max_freq);
-              _model.state.gyroDynNotchFilter[p][x].reconfigure(f, f, q);
+              _model.state.gyroDynNotchFilter[p].reconfigureAxis(x, f, f, q);
             }
           }
         }
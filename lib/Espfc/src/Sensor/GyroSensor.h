@@ -4,7 +4,9 @@
 #include "Model.h"
 #include "Device/GyroDevice.h"
 #include "Math/Sma.h"
-#ifdef ESPFC_DSP
+#if defined(ESPFC_SDFT)
+#include "Math/SdftAnalyzer.h"
+#elif defined(ESPFC_FFT)
 #include "Math/FFTAnalyzer.h"
 #else
 #include "Math/FreqAnalyzer.h"
@@ -13,6 +15,10 @@
 #define ESPFC_FUZZY_ACCEL_ZERO 0.05
 #define ESPFC_FUZZY_GYRO_ZERO  0.20
 
+#ifndef ESPFC_FFT_SIZE
+#define ESPFC_FFT_SIZE 128
+#endif
+
 namespace Espfc {
 
 namespace Sensor {
@@ -38,7 +44,6 @@ class GyroSensor: public BaseSensor
     bool _dyn_notch_enabled;
     bool _dyn_notch_debug;
     bool _rpm_enabled;
-    size_t _rpm_motor_index;
     float _rpm_weights[3];
     float _rpm_fade_inv;
     float _rpm_min_freq;
@@ -48,8 +53,10 @@ class GyroSensor: public BaseSensor
     Model& _model;
     Device::GyroDevice * _gyro;
 
-#ifdef ESPFC_DSP
-    Math::FFTAnalyzer<128> _fft[3];
+#if defined(ESPFC_SDFT)
+    Math::SdftAnalyzer<ESPFC_FFT_SIZE> _fft[3];
+#elif defined(ESPFC_FFT)
+    Math::FFTAnalyzer<ESPFC_FFT_SIZE> _fft[3];
 #else
     Math::FreqAnalyzer _freqAnalyzer[3];
 #endif
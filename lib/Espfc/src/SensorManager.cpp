@@ -2,7 +2,7 @@
 
 namespace Espfc {
 
-SensorManager::SensorManager(Model& model): _model(model), _gyro(model), _accel(model), _mag(model), _baro(model), _voltage(model), _fusion(model), _fusionUpdate(false) {}
+SensorManager::SensorManager(Model& model): _model(model), _gyro(model), _accel(model), _mag(model), _baro(model), _voltage(model), _fusion(model) {}
 
 int SensorManager::begin()
 {
@@ -16,6 +16,7 @@ int SensorManager::begin()
   return 1;
 }
 
+// multi core gyro task, other sensors are scheduled separately
 int FAST_CODE_ATTR SensorManager::read()
 {
   _gyro.read();
@@ -25,20 +26,7 @@ int FAST_CODE_ATTR SensorManager::read()
     _model.state.appQueue.send(Event(EVENT_GYRO_READ));
   }
 
-  if(_model.state.accelTimer.syncTo(_model.state.gyroTimer))
-  {
-    _accel.update();
-    _model.state.appQueue.send(Event(EVENT_ACCEL_READ));
-    return 1;
-  }
-
-  if(_mag.update()) return 1;
-
-  if(_baro.update()) return 1;
-
-  if(_voltage.update()) return 1;
-
-  return 0;
+  return 1;
 }
 
 int FAST_CODE_ATTR SensorManager::preLoop()
@@ -63,43 +51,31 @@ int FAST_CODE_ATTR SensorManager::fusion()
   return _fusion.update();
 }
 
-// main task
+// single core gyro task
 int FAST_CODE_ATTR SensorManager::update()
 {
   _gyro.read();
   return preLoop();
 }
 
-// sub task
-int SensorManager::updateDelayed()
+int SensorManager::accel()
 {
-  _gyro.postLoop();
-
-  // update at most one sensor besides gyro
-  int status = 0;
-  if(_model.state.accelTimer.syncTo(_model.state.gyroTimer))
-  {
-    _accel.update();
-    status = 1;
-  }
-
-  // delay imu update to next cycle
-  if(_fusionUpdate)
-  {
-    _fusionUpdate = false;
-    _fusion.update();
-  }
-  _fusionUpdate = status;
-
-  if(status) return 1;
-
-  if(_mag.update()) return 1;
+  return _accel.update();
+}
 
-  if(_baro.update()) return 1;
+int SensorManager::mag()
+{
+  return _mag.update();
+}
 
-  if(_voltage.update()) return 0;
+int SensorManager::baro()
+{
+  return _baro.update();
+}
 
-  return 0;
+int SensorManager::voltage()
+{
+  return _voltage.update();
 }
 
 }
@@ -20,10 +20,12 @@ class SensorManager
     int preLoop();
     int postLoop();
     int fusion();
-    // main task
+    int accel();
+    int mag();
+    int baro();
+    int voltage();
+    // single core gyro task
     int update();
-    // sub task
-    int updateDelayed();
 
   private:
     Model& _model;
@@ -33,7 +35,6 @@ class SensorManager
     Sensor::BaroSensor _baro;
     Sensor::VoltageSensor _voltage;
     Fusion _fusion;
-    bool _fusionUpdate;
 };
 
 }
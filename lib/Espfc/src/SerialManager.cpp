@@ -138,6 +138,8 @@ int SerialManager::begin()
 
 int FAST_CODE_ATTR SerialManager::update()
 {
+  if(SERIAL_UART_COUNT == 0) return 0; // target without serial ports
+
   Stats::Measure measure(_model.state.stats, COUNTER_SERIAL);
 
   //D("serial", _current);
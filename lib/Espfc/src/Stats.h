@@ -3,6 +3,8 @@
 
 #include "Arduino.h"
 #include "Timer.h"
+#include "Target/Timebase.h"
+#include "Utils/Histogram.h"
 
 namespace Espfc {
 
@@ -32,6 +34,7 @@ enum StatCounter : int8_t {
   COUNTER_SERIAL,
   COUNTER_WIFI,
   COUNTER_BATTERY,
+  COUNTER_WAKEUP,
   COUNTER_CPU_0,
   COUNTER_CPU_1,
   COUNTER_COUNT
@@ -56,7 +59,7 @@ class Stats
         StatCounter _counter;
     };
 
-    Stats(): _loop_last(0), _loop_time(0)
+    Stats(): _loop_last(0), _loop_time(0), _cyclesPerUs(1), _usPerCycle(1.f), _histShift(0)
     {
       for(size_t i = 0; i < COUNTER_COUNT; i++)
       {
@@ -68,16 +71,47 @@ class Stats
       }
     }
 
+    /**
+     * @brief Set timebase frequency, durations are kept in cycles and converted to us only when reported
+     */
+    void begin(uint32_t cycleFreq)
+    {
+      _cyclesPerUs = std::max(cycleFreq / 1000000u, (uint32_t)1);
+      _usPerCycle = 1e6f / cycleFreq;
+      // histogram unit close to 1/4 us, so buckets cover from sub us kernels to few ms tasks
+      _histShift = 0;
+      while((cycleFreq >> (_histShift + 1)) >= 4000000u) _histShift++;
+      reset();
+    }
+
     inline void start(StatCounter c) IRAM_ATTR
     {
-      _start[c] = micros();
+      _start[c] = targetCycles();
     }
 
     inline void end(StatCounter c) IRAM_ATTR
     {
-      uint32_t diff = micros() - _start[c];
-      _sum[c] += diff;
+      add(c, targetCycles() - _start[c]);
+    }
+
+    // duration in timebase cycles
+    inline void add(StatCounter c, uint32_t cycles) IRAM_ATTR
+    {
+      _sum[c] += cycles;
       _count[c]++;
+      _hist[c].add(cycles >> _histShift);
+    }
+
+    // duration in us measured elsewhere, e.g. between cores, which don't share cycle counter
+    inline void addMicros(StatCounter c, uint32_t us) IRAM_ATTR
+    {
+      add(c, us * _cyclesPerUs);
+    }
+
+    // clears min, max and histograms, averages are windowed anyway
+    void reset()
+    {
+      for(size_t i = 0; i < COUNTER_COUNT; i++) _hist[i].reset();
     }
 
     void loopTick()
@@ -99,9 +133,10 @@ class Stats
       if(!timer.check()) return;
       for(size_t i = 0; i < COUNTER_COUNT; i++)
       {
-        _avg[i] = (float)(_sum[i] + (_count[i] >> 1)) / timer.delta;
+        const float time = _sum[i] * _usPerCycle;
+        _avg[i] = time / timer.delta;
         _freq[i] = (float)_count[i] * 1e6 / timer.delta;
-        _real[i] = _count[i] > 0 ? ((float)(_sum[i] + (_count[i] >> 1)) / _count[i]) : 0.0f;
+        _real[i] = _count[i] > 0 ? time / _count[i] : 0.0f;
         _sum[i] = 0;
         _count[i] = 0;
       }
@@ -130,12 +165,38 @@ class Stats
       return _freq[c];
     }
 
+    /**
+     * @brief Number of measurements since reset
+     */
+    uint32_t getSamples(StatCounter c) const
+    {
+      return _hist[c].count();
+    }
+
+    /**
+     * @brief Distribution of single measurements since reset, in us
+     */
+    float getMin(StatCounter c) const
+    {
+      return toMicros(_hist[c].min());
+    }
+
+    float getMax(StatCounter c) const
+    {
+      return toMicros(_hist[c].max());
+    }
+
+    float getPercentile(StatCounter c, float p) const
+    {
+      return toMicros(_hist[c].percentile(p));
+    }
+
     float getTotalLoad() const
     {
       float ret = 0;
       for(size_t i = 0; i < COUNTER_COUNT; i++)
       {
-        if(i == COUNTER_CPU_0 || i == COUNTER_CPU_1) continue;
+        if(i == COUNTER_CPU_0 || i == COUNTER_CPU_1 || i == COUNTER_WAKEUP) continue;
         ret += getLoad((StatCounter)i);
       }
       return ret;
@@ -146,7 +207,7 @@ class Stats
       float ret = 0;
       for(size_t i = 0; i < COUNTER_COUNT; i++)
       {
-        if(i == COUNTER_CPU_0 || i == COUNTER_CPU_1) continue;
+        if(i == COUNTER_CPU_0 || i == COUNTER_CPU_1 || i == COUNTER_WAKEUP) continue;
         ret += getTime((StatCounter)i);
       }
       return ret;
@@ -196,6 +257,7 @@ class Stats
         case COUNTER_WIFI:         return PSTR("  wifi");
         case COUNTER_BATTERY:      return PSTR("   bat");
         case COUNTER_TELEMETRY:    return PSTR("   tlm");
+        case COUNTER_WAKEUP:       return PSTR("wakeup");
         case COUNTER_CPU_0:        return PSTR(" cpu_0");
         case COUNTER_CPU_1:        return PSTR(" cpu_1");
         default:                   return PSTR("unknwn");
@@ -205,14 +267,23 @@ class Stats
     Timer timer;
 
   private:
+    float toMicros(uint32_t units) const
+    {
+      return (units << _histShift) * _usPerCycle;
+    }
+
     uint32_t _start[COUNTER_COUNT];
     uint32_t _sum[COUNTER_COUNT];
     uint32_t _count[COUNTER_COUNT];
     float _avg[COUNTER_COUNT];
     float _freq[COUNTER_COUNT];
     float _real[COUNTER_COUNT];
+    Utils::Histogram _hist[COUNTER_COUNT];
     uint32_t _loop_last;
     int32_t _loop_time;
+    uint32_t _cyclesPerUs;
+    float _usPerCycle;
+    uint8_t _histShift;
 };
 
 }
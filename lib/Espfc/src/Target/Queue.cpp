@@ -1,6 +1,6 @@
 #include "Target.h"
 
-#if defined(UNIT_TEST) || !defined(ESPFC_MULTI_CORE)
+#if !defined(ESPFC_ATOMIC_QUEUE) && (defined(UNIT_TEST) || !defined(ESPFC_MULTI_CORE))
 
 #include "Queue.h"
 
@@ -14,6 +14,8 @@ void FAST_CODE_ATTR Queue::send(const Event& e) { (void)e; }
 
 Event FAST_CODE_ATTR Queue::receive() { return Event(); }
 
+bool FAST_CODE_ATTR Queue::receive(Event& e, uint32_t timeout) { (void)e; (void)timeout; return false; }
+
 bool FAST_CODE_ATTR Queue::isEmpty() const { return true; }
 
 bool FAST_CODE_ATTR Queue::isFull() const { return false; }
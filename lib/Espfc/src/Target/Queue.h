@@ -4,6 +4,8 @@
 // https://techtutorialsx.com/2017/08/20/esp32-arduino-freertos-queues/
 // https://www.freertos.org/a00116.html
 
+#include <cstdint>
+
 namespace Espfc {
 
 enum EventType
@@ -35,6 +37,13 @@ class Event
 #elif defined(ESPFC_ATOMIC_QUEUE)
   #include "QueueAtomic.h"
   typedef Espfc::QueueAtomic<Espfc::Event, 63> TargetQueueHandle;
+  #if defined(ESPFC_FREE_RTOS)
+    #include <freertos/FreeRTOS.h>
+    #include <freertos/task.h>
+  #else
+    #include <mutex>
+    #include <condition_variable>
+  #endif
 #elif defined(UNIT_TEST) || !defined(ESPFC_MULTI_CORE)
   typedef int TargetQueueHandle;
 #else
@@ -51,11 +60,26 @@ class Queue
     void begin();
     void send(const Event& e);
     Event receive();
+    // sleeps until event arrives or timeout [us] elapses, returns false on timeout
+    // on FreeRTOS it may rarely return false early, when notification of previous wait came late
+    bool receive(Event& e, uint32_t timeout);
     bool isEmpty() const;
     bool isFull() const;
 
   private:
     TargetQueueHandle _q;
+#if defined(ESPFC_ATOMIC_QUEUE)
+    void wait(uint32_t timeout);
+    void notify();
+    void clearNotify();
+    std::atomic<bool> _waiting;
+  #if defined(ESPFC_FREE_RTOS)
+    std::atomic<TaskHandle_t> _waiter;
+  #else
+    std::mutex _mutex;
+    std::condition_variable _cond;
+  #endif
+#endif
 };
 
 }
@@ -10,12 +10,18 @@ namespace Target {
 
 void Queue::begin()
 {
+  _waiting = false;
+#if defined(ESPFC_FREE_RTOS)
+  _waiter = nullptr;
+#endif
 }
 
 void FAST_CODE_ATTR Queue::send(const Event& e)
 {
   if(isFull()) return;
   _q.push(e);
+  // wake receiver only if it sleeps, sender does not pay for it otherwise
+  if(_waiting.exchange(false)) notify();
 }
 
 Event FAST_CODE_ATTR Queue::receive()
@@ -25,6 +31,28 @@ Event FAST_CODE_ATTR Queue::receive()
   return e;
 }
 
+bool FAST_CODE_ATTR Queue::receive(Event& e, uint32_t timeout)
+{
+  if(_q.pop(e)) return true;
+  if(!timeout) return false;
+
+#if defined(ESPFC_FREE_RTOS)
+  _waiter = xTaskGetCurrentTaskHandle();
+#endif
+  _waiting = true;
+  // recheck, event might be sent before waiting flag was visible
+  if(_q.pop(e))
+  {
+    // sender already took the flag, drop its notification so next wait does not return at once
+    if(!_waiting.exchange(false)) clearNotify();
+    return true;
+  }
+  wait(timeout);
+  _waiting = false;
+
+  return _q.pop(e);
+}
+
 bool FAST_CODE_ATTR Queue::isEmpty() const
 {
   return _q.isEmpty();
@@ -35,6 +63,46 @@ bool FAST_CODE_ATTR Queue::isFull() const
   return _q.isFull();
 }
 
+#if defined(ESPFC_FREE_RTOS)
+
+void FAST_CODE_ATTR Queue::wait(uint32_t timeout)
+{
+  const TickType_t ticks = pdMS_TO_TICKS(timeout / 1000);
+  // notification given before take is not lost, take returns immediately
+  ulTaskNotifyTake(pdTRUE, ticks > 0 ? ticks : 1);
+}
+
+void FAST_CODE_ATTR Queue::notify()
+{
+  TaskHandle_t waiter = _waiter;
+  if(waiter) xTaskNotifyGive(waiter);
+}
+
+void FAST_CODE_ATTR Queue::clearNotify()
+{
+  ulTaskNotifyTake(pdTRUE, 0);
+}
+
+#else
+
+void Queue::wait(uint32_t timeout)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _cond.wait_for(lock, std::chrono::microseconds(timeout), [this]() { return !_q.isEmpty(); });
+}
+
+void Queue::notify()
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  _cond.notify_one();
+}
+
+void Queue::clearNotify()
+{
+}
+
+#endif
+
 }
 
 }
@@ -26,6 +26,12 @@ Event Queue::receive()
   return e;
 }
 
+bool Queue::receive(Event& e, uint32_t timeout)
+{
+  const TickType_t ticks = pdMS_TO_TICKS(timeout / 1000);
+  return xQueueReceive(_q, &e, timeout && !ticks ? 1 : ticks) == pdTRUE;
+}
+
 bool Queue::isEmpty() const
 {
   return uxQueueMessagesWaiting(_q) == 0;
@@ -27,6 +27,17 @@ Event Queue::receive()
   return e;
 }
 
+bool Queue::receive(Event& e, uint32_t timeout)
+{
+  const absolute_time_t until = make_timeout_time_us(timeout);
+  // queue_add signals event, core sleeps until it or timeout
+  while(!queue_try_remove(&_q, &e))
+  {
+    if(best_effort_wfe_or_timeout(until)) return queue_try_remove(&_q, &e);
+  }
+  return true;
+}
+
 bool Queue::isEmpty() const
 {
   return queue_is_empty(const_cast<TargetQueueHandle*>(&_q));
@@ -0,0 +1,70 @@
+#pragma once
+
+// https://lwn.net/Articles/590243/ (seqcount latch)
+
+#if defined(ESPFC_MULTI_CORE) || defined(UNIT_TEST)
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+namespace Espfc {
+
+/**
+ * Single producer, single consumer snapshot channel.
+ * Payload is stored twice, producer updates one copy while consumer may read the other,
+ * so write() never waits and read() retries only if producer passed both copies during the copy.
+ */
+template<typename Element>
+class SeqLock
+{
+public:
+  SeqLock(): _seq(0), _seen(0), _buf() {}
+
+  void write(const Element& item)
+  {
+    const uint32_t seq = _seq.load(std::memory_order_relaxed);
+
+    // odd sequence directs readers to second copy
+    _seq.store(seq + 1, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_release);
+    _buf[0] = item;
+
+    _seq.store(seq + 2, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_release);
+    _buf[1] = item;
+  }
+
+  // copies latest coherent item, returns its version, 0 if nothing was written yet
+  uint32_t read(Element& item) const
+  {
+    uint32_t seq;
+    do
+    {
+      seq = _seq.load(std::memory_order_acquire);
+      item = _buf[seq & 1];
+      std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    while(seq != _seq.load(std::memory_order_relaxed));
+    return seq >> 1;
+  }
+
+  // like read(), but only if written since last receive()
+  bool receive(Element& item)
+  {
+    if(version() == _seen) return false;
+    _seen = read(item);
+    return true;
+  }
+
+  uint32_t version() const { return _seq.load(std::memory_order_acquire) >> 1; }
+
+private:
+  std::atomic<uint32_t> _seq;
+  uint32_t _seen;
+  Element _buf[2];
+};
+
+}
+
+#endif
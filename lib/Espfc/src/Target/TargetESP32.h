@@ -88,5 +88,6 @@
 #define ESPFC_ATOMIC_QUEUE
 
 #define ESPFC_DSP
+#define ESPFC_FFT
 
 #include "Target/TargetEsp32Common.h"
@@ -77,6 +77,7 @@
 #define ESPFC_GYRO_SPI_RATE_MAX 2000
 
 #define ESPFC_DSP
+#define ESPFC_FFT
 
 #include "Device/SerialDevice.h"
 
@@ -99,6 +99,7 @@
 #define ESPFC_ATOMIC_QUEUE
 
 #define ESPFC_DSP
+#define ESPFC_FFT
 
 #include "Device/SerialDevice.h"
 
@@ -74,6 +74,8 @@
 #define ESPFC_MULTI_CORE
 #define ESPFC_MULTI_CORE_RP2040
 
+#define ESPFC_FFT
+
 #include "Device/SerialDevice.h"
 #include "Debug_Espfc.h"
 #include <hardware/gpio.h>
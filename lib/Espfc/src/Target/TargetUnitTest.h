@@ -16,6 +16,8 @@
 
 #define ESPFC_GUARD 1
 
+#define ESPFC_FFT
+
 #define ESPFC_GYRO_I2C_RATE_MAX 2000
 #define ESPFC_GYRO_SPI_RATE_MAX 8000
 
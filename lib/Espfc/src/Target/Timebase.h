@@ -0,0 +1,52 @@
+#pragma once
+
+// https://docs.espressif.com/projects/esp-idf/en/stable/esp32/api-reference/system/perfmon.html
+// https://www.raspberrypi.com/documentation/pico-sdk/hardware.html#hardware_timer
+
+#include <cstdint>
+
+#if defined(ARCH_RP2040)
+  #include <hardware/structs/timer.h>
+#elif defined(ESP8266) || defined(ESP32)
+  #include <Esp.h>
+#elif defined(UNIT_TEST)
+  #include <ctime>
+#else
+  #error "Unsupported platform!"
+#endif
+
+namespace Espfc {
+
+/**
+ * Free running counter for profiling, cheaper and finer than micros().
+ * Xtensa reads CCOUNT, RISC-V (esp32c3) machine performance counter, both at cpu clock and per core,
+ * so both ends of measurement must run on the same core. RP2040 has no cycle counter on Cortex-M0+,
+ * and SysTick is 24 bit and may be used by rtos, so raw 1MHz timer register is read instead of micros() call.
+ * Native uses monotonic clock in ns. Counter wraps at 32 bits, only differences are meaningful.
+ */
+inline uint32_t targetCycles()
+{
+#if defined(ARCH_RP2040)
+  return timer_hw->timerawl;
+#elif defined(ESP8266) || defined(ESP32)
+  return ESP.getCycleCount();
+#else
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)ts.tv_sec * 1000000000u + (uint32_t)ts.tv_nsec;
+#endif
+}
+
+// counter ticks per second
+inline uint32_t targetCycleFreq()
+{
+#if defined(ARCH_RP2040)
+  return 1000000u;
+#elif defined(ESP8266) || defined(ESP32)
+  return ESP.getCpuFreqMHz() * 1000000u;
+#else
+  return 1000000000u;
+#endif
+}
+
+}
@@ -0,0 +1,92 @@
+#include "FilterLatency.h"
+#include "Model.h"
+
+namespace Espfc {
+
+namespace Utils {
+
+FilterLatency::FilterLatency(const Model& model): _model(model)
+{
+  for(size_t i = 0; i < STAGE_COUNT; i++) delay[i] = 0.f;
+}
+
+void FilterLatency::compute(float freq, size_t axis)
+{
+  const ModelConfig& config = _model.config;
+  const ModelState& state = _model.state;
+  if(axis >= FilterBank3::AXES) axis = 0;
+
+  for(size_t i = 0; i < STAGE_COUNT; i++) delay[i] = 0.f;
+
+  // gyro sampling, same choice as GyroSensor::read()
+  if(config.gyroFilter3.freq)
+  {
+    delay[GYRO_LPF3] = state.gyroFilter3.getGroupDelay(freq, axis);
+  }
+  else if(state.gyroRate > 0)
+  {
+    const size_t count = std::min(std::max((int)config.loopSync, 1), 8);
+    delay[GYRO_SMA] = (count - 1) * 0.5f / state.gyroRate;
+  }
+
+  delay[GYRO_LPF2] = state.gyroFilter2.getGroupDelay(freq, axis);
+  if(config.rpmFilterHarmonics > 0 && config.output.dshotTelemetry)
+  {
+    delay[GYRO_RPM] = state.rpmFilter.getGroupDelay(freq);
+  }
+  delay[GYRO_NOTCH1] = state.gyroNotch1Filter.getGroupDelay(freq, axis);
+  delay[GYRO_NOTCH2] = state.gyroNotch2Filter.getGroupDelay(freq, axis);
+  delay[GYRO_LPF1] = state.gyroFilter.getGroupDelay(freq, axis);
+
+  // same condition as GyroSensor::begin()
+  if(_model.isActive(FEATURE_DYNAMIC_FILTER) && state.loopTimer.rate >= DynamicFilterConfig::MIN_FREQ)
+  {
+    const size_t count = sizeof(state.gyroDynNotchFilter) / sizeof(state.gyroDynNotchFilter[0]);
+    for(size_t p = 0; p < (size_t)config.dynamicFilter.width && p < count; p++)
+    {
+      delay[GYRO_DYN_NOTCH] += state.gyroDynNotchFilter[p].getGroupDelay(freq, axis);
+    }
+  }
+
+  const Control::Pid& pid = state.innerPid[axis];
+  if(pid.rate > 0.f)
+  {
+    delay[DTERM_DIFF] = 0.5f / pid.rate;
+  }
+  delay[DTERM_NOTCH] = pid.dtermNotchFilter.getGroupDelay(freq);
+  delay[DTERM_LPF1] = pid.dtermFilter.getGroupDelay(freq);
+  delay[DTERM_LPF2] = pid.dtermFilter2.getGroupDelay(freq);
+}
+
+float FilterLatency::gyro() const
+{
+  float sum = 0.f;
+  for(size_t i = GYRO_SMA; i < DTERM_DIFF; i++) sum += delay[i];
+  return sum;
+}
+
+float FilterLatency::dterm() const
+{
+  float sum = gyro();
+  for(size_t i = DTERM_DIFF; i < STAGE_COUNT; i++) sum += delay[i];
+  return sum;
+}
+
+uint16_t FilterLatency::defaultFreq(size_t i)
+{
+  static const uint16_t freqs[DEFAULT_FREQ_COUNT] = { 10, 25, 50, 100, 200 };
+  return i < DEFAULT_FREQ_COUNT ? freqs[i] : 0;
+}
+
+const char * FilterLatency::name(size_t stage)
+{
+  static const char * const names[] = {
+    "gyro_sma", "gyro_lpf3", "gyro_lpf2", "gyro_rpm", "gyro_notch1", "gyro_notch2", "gyro_lpf", "gyro_dyn_notch",
+    "dterm_diff", "dterm_notch", "dterm_lpf", "dterm_lpf2",
+  };
+  return stage < STAGE_COUNT ? names[stage] : "";
+}
+
+}
+
+}
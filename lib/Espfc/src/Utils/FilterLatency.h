@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Espfc {
+
+class Model;
+
+namespace Utils {
+
+/**
+ * Group delay budget of gyro and dterm filter chains, computed from coefficients currently in use.
+ * Intended for cli and msp, it is too slow to run inside of control loop.
+ */
+class FilterLatency
+{
+  public:
+    enum Stage {
+      GYRO_SMA,       // sample averaging, if gyro lpf3 is off
+      GYRO_LPF3,
+      GYRO_LPF2,
+      GYRO_RPM,
+      GYRO_NOTCH1,
+      GYRO_NOTCH2,
+      GYRO_LPF1,
+      GYRO_DYN_NOTCH,
+      DTERM_DIFF,     // backward difference
+      DTERM_NOTCH,
+      DTERM_LPF1,
+      DTERM_LPF2,
+      STAGE_COUNT,
+    };
+
+    explicit FilterLatency(const Model& model);
+
+    // compute delay of all stages at freq [Hz] for given axis
+    void compute(float freq, size_t axis = 0);
+
+    float gyro() const;  // seconds, gyro path
+    float dterm() const; // seconds, gyro path followed by dterm filters
+
+    static const char * name(size_t stage);
+    // frequencies [Hz] reported when none requested
+    static constexpr size_t DEFAULT_FREQ_COUNT = 5;
+    static uint16_t defaultFreq(size_t i);
+    // phase lag in degrees caused by delay [s] at freq [Hz]
+    static float phase(float delay, float freq) { return delay * freq * 360.f; }
+
+    float delay[STAGE_COUNT]; // seconds
+
+  private:
+    const Model& _model;
+};
+
+}
+
+}
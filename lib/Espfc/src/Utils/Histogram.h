@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Espfc {
+
+namespace Utils {
+
+/**
+ * Log-linear histogram of durations with min and max.
+ * Every octave is split into 4 buckets, so percentile error is below 25%, values over 2^16 land in last bucket.
+ * add() is a few instructions (clz, shift, increment), when bucket saturates all buckets are halved,
+ * which keeps proportions, so it may run for whole flight.
+ */
+class Histogram
+{
+public:
+  static constexpr size_t SUB_BITS = 2;
+  static constexpr size_t SUB = 1 << SUB_BITS;
+  static constexpr size_t BUCKETS = 16 * SUB;
+
+  Histogram() { reset(); }
+
+  void reset()
+  {
+    for(size_t i = 0; i < BUCKETS; i++) _bucket[i] = 0;
+    _count = 0;
+    _min = UINT32_MAX;
+    _max = 0;
+  }
+
+  inline void add(uint32_t v)
+  {
+    if(v < _min) _min = v;
+    if(v > _max) _max = v;
+    _count++;
+    if(++_bucket[index(v)] == UINT16_MAX) decay();
+  }
+
+  uint32_t count() const { return _count; }
+  uint32_t min() const { return _count ? _min : 0; }
+  uint32_t max() const { return _max; }
+
+  // upper bound of bucket containing p-th fraction of samples, limited by min and max
+  uint32_t percentile(float p) const
+  {
+    uint32_t total = 0;
+    for(size_t i = 0; i < BUCKETS; i++) total += _bucket[i];
+    if(!total) return 0;
+
+    const uint32_t target = total * p + 0.5f;
+    uint32_t sum = 0;
+    size_t i = 0;
+    for(; i < BUCKETS - 1; i++)
+    {
+      sum += _bucket[i];
+      if(sum >= target && sum > 0) break;
+    }
+    const uint32_t v = i < BUCKETS - 1 ? lowerBound(i + 1) - 1 : _max;
+    return v < min() ? min() : (v > _max ? _max : v);
+  }
+
+  static inline size_t index(uint32_t v)
+  {
+    if(v < SUB) return v;
+    const uint32_t e = 31 - __builtin_clz(v);
+    const size_t i = ((e - SUB_BITS + 1) << SUB_BITS) | ((v >> (e - SUB_BITS)) & (SUB - 1));
+    return i < BUCKETS ? i : BUCKETS - 1;
+  }
+
+  static inline uint32_t lowerBound(size_t i)
+  {
+    if(i < SUB) return i;
+    const uint32_t e = (i >> SUB_BITS) + SUB_BITS - 1;
+    return (SUB | (i & (SUB - 1))) << (e - SUB_BITS);
+  }
+
+private:
+  void decay()
+  {
+    for(size_t i = 0; i < BUCKETS; i++) _bucket[i] >>= 1;
+  }
+
+  uint16_t _bucket[BUCKETS];
+  uint32_t _count;
+  uint32_t _min;
+  uint32_t _max;
+};
+
+}
+
+}
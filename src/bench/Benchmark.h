@@ -0,0 +1,186 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+namespace Espfc {
+
+namespace Bench {
+
+/**
+ * Minimal micro benchmark harness.
+ * Each kernel runs in batches of calibrated size, best batch is reported as ns/op,
+ * results can be written as json and compared against baseline from previous run.
+ */
+class Benchmark
+{
+  public:
+    typedef std::function<void(size_t)> KernelFn;
+
+    struct Result
+    {
+      std::string name;
+      double ns;
+      double ops;
+      double baseline;
+    };
+
+    static constexpr double BATCH_TIME_NS = 5e6; // 5ms per batch
+    static constexpr size_t BATCH_COUNT = 7;
+
+    Benchmark(): _filter(nullptr), _idle(nullptr) {}
+
+    void add(const std::string& name, KernelFn fn)
+    {
+      _kernels.push_back(Kernel{name, fn});
+    }
+
+    // called between batches, outside of measured section
+    void setIdle(std::function<void()> fn)
+    {
+      _idle = fn;
+    }
+
+    void setFilter(const char * filter)
+    {
+      _filter = filter;
+    }
+
+    void run()
+    {
+      _results.clear();
+      for(const Kernel& k: _kernels)
+      {
+        if(_filter && k.name.find(_filter) == std::string::npos) continue;
+        const double ns = measure(k.fn);
+        _results.push_back(Result{k.name, ns, ns > 0 ? 1e9 / ns : 0, 0});
+      }
+    }
+
+    const std::vector<Result>& results() const
+    {
+      return _results;
+    }
+
+    void print() const
+    {
+      std::printf("%-28s %10s %14s %10s\n", "kernel", "ns/op", "ops/s", "change");
+      for(const Result& r: _results)
+      {
+        std::printf("%-28s %10.2f %14.0f", r.name.c_str(), r.ns, r.ops);
+        if(r.baseline > 0) std::printf(" %+9.1f%%", change(r));
+        std::printf("\n");
+      }
+    }
+
+    bool writeJson(const char * path) const
+    {
+      FILE * f = std::fopen(path, "w");
+      if(!f) return false;
+      std::fprintf(f, "{\n  \"kernels\": [\n");
+      for(size_t i = 0; i < _results.size(); i++)
+      {
+        const Result& r = _results[i];
+        // one kernel per line, loadBaseline() relies on it
+        std::fprintf(f, "    {\"name\": \"%s\", \"ns\": %.3f, \"ops\": %.0f}%s\n", r.name.c_str(), r.ns, r.ops, i + 1 < _results.size() ? "," : "");
+      }
+      std::fprintf(f, "  ]\n}\n");
+      std::fclose(f);
+      return true;
+    }
+
+    bool loadBaseline(const char * path)
+    {
+      FILE * f = std::fopen(path, "r");
+      if(!f) return false;
+      char line[256];
+      while(std::fgets(line, sizeof(line), f))
+      {
+        char name[64];
+        double ns;
+        const char * p = std::strstr(line, "\"name\"");
+        if(!p || std::sscanf(p, "\"name\": \"%63[^\"]\", \"ns\": %lf", name, &ns) != 2) continue;
+        for(Result& r: _results)
+        {
+          if(r.name == name) r.baseline = ns;
+        }
+      }
+      std::fclose(f);
+      return true;
+    }
+
+    // number of kernels slower than baseline by more than threshold [%]
+    size_t regressions(double threshold) const
+    {
+      size_t count = 0;
+      for(const Result& r: _results)
+      {
+        if(r.baseline > 0 && change(r) > threshold) count++;
+      }
+      return count;
+    }
+
+    static double change(const Result& r)
+    {
+      return (r.ns - r.baseline) * 100.0 / r.baseline;
+    }
+
+  private:
+    struct Kernel
+    {
+      std::string name;
+      KernelFn fn;
+    };
+
+    double measure(const KernelFn& fn)
+    {
+      // calibrate batch size
+      size_t n = 16;
+      while(true)
+      {
+        const double t = time(fn, n);
+        if(t >= BATCH_TIME_NS || n >= (1u << 30)) break;
+        n = t > 0 ? std::max(n * 2, (size_t)(n * BATCH_TIME_NS / t)) : n * 16;
+      }
+
+      // best batch is least affected by host scheduling
+      double best = 0;
+      for(size_t i = 0; i < BATCH_COUNT; i++)
+      {
+        const double ns = time(fn, n) / n;
+        if(i == 0 || ns < best) best = ns;
+      }
+      return best;
+    }
+
+    double time(const KernelFn& fn, size_t n)
+    {
+      if(_idle) _idle();
+      auto start = std::chrono::steady_clock::now();
+      fn(n);
+      auto end = std::chrono::steady_clock::now();
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    }
+
+    std::vector<Kernel> _kernels;
+    std::vector<Result> _results;
+    const char * _filter;
+    std::function<void()> _idle;
+};
+
+// keeps result alive, so compiler can't drop benchmarked code
+template<typename T>
+inline void consume(const T& v)
+{
+  asm volatile("" : : "g"(&v) : "memory");
+}
+
+}
+
+}
@@ -0,0 +1,834 @@
+// Micro benchmarks of flight loop kernels, runs on host.
+// build: pio run -e bench
+// run:   .pio/build/bench/program [-f filter] [-j out.json] [-b baseline.json] [-t threshold_percent]
+
+#include <ArduinoFake.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <thread>
+#include <EscDriver.h>
+#include "Model.h"
+#include "Filter.h"
+#include "FilterBank3.h"
+#include "FilterFixed.h"
+#include "FilterChain.h"
+#include "RpmFilter.h"
+#include "Utils/FilterHelper.h"
+#include "Control/Pid.h"
+#include "Control/Pid3.h"
+#include "Control/Rates.h"
+#include "Output/Mixer.h"
+#include "Output/Mixers.h"
+#include "Rc/Crsf.h"
+#include "Msp/MspParser.h"
+#include "Math/Crc.h"
+#include "Math/Utils.h"
+#include "Math/FixedPoint.h"
+#include "Math/FreqAnalyzer.h"
+#include "Math/SdftAnalyzer.h"
+#include "Math/FFTAnalyzer.h"
+#include "Math/FFTReal.h"
+#include "Target/SeqLock.h"
+#ifdef ESPFC_DSP
+#include "dsps_fft4r.h"
+#endif
+#include "Benchmark.h"
+
+using namespace fakeit;
+using namespace Espfc;
+using Espfc::Bench::Benchmark;
+using Espfc::Bench::consume;
+
+namespace {
+
+static constexpr int RATE = 8000;
+static constexpr size_t SAMPLES = 1024; // power of 2
+static float samples[SAMPLES];
+static int32_t samplesQ16[SAMPLES];
+
+uint32_t fakeTime = 0;
+
+void benchInitFakes()
+{
+  When(Method(ArduinoFake(), micros)).AlwaysDo([]() -> unsigned long { return fakeTime++; });
+  When(Method(ArduinoFake(), millis)).AlwaysDo([]() -> unsigned long { return fakeTime / 1000; });
+}
+
+void benchResetFakes()
+{
+  // fakes record every invocation, keep memory bounded
+  ArduinoFakeReset();
+  benchInitFakes();
+}
+
+void initSamples()
+{
+  std::mt19937 rng(1);
+  std::normal_distribution<float> noise(0.f, 1.f);
+  for(size_t i = 0; i < SAMPLES; i++)
+  {
+    const float t = (float)i / RATE;
+    samples[i] = 50.f * std::sin(2.f * (float)M_PI * 230.f * t) + 20.f * std::sin(2.f * (float)M_PI * 460.f * t) + 5.f * noise(rng);
+    samplesQ16[i] = Math::toQ16(samples[i]);
+  }
+}
+
+inline float sample(size_t i)
+{
+  return samples[i & (SAMPLES - 1)];
+}
+
+inline int32_t sampleQ16(size_t i)
+{
+  return samplesQ16[i & (SAMPLES - 1)];
+}
+
+// gyro path with static notches off: lpf2, notch1, notch2, lpf1
+struct GyroStages
+{
+  FilterBank3 filter[4];
+};
+
+template<size_t index>
+struct GyroStage
+{
+  static inline void apply(GyroStages& s, VectorFloat& v) { v = s.filter[index].update(v); }
+};
+
+template<size_t mask>
+using GyroStagesChain = FilterChain<GyroStages, VectorFloat,
+  FilterStageIf<(mask & 1) != 0, GyroStage<0>>,
+  FilterStageIf<(mask & 2) != 0, GyroStage<1>>,
+  FilterStageIf<(mask & 4) != 0, GyroStage<2>>,
+  FilterStageIf<(mask & 8) != 0, GyroStage<3>>
+>;
+
+void initGyroStages(GyroStages& s)
+{
+  s.filter[0].begin(FilterConfig(FILTER_PT1, 213), RATE);
+  s.filter[1].begin(FilterConfig(FILTER_NOTCH, 0, 0), RATE);
+  s.filter[2].begin(FilterConfig(FILTER_NOTCH, 0, 0), RATE);
+  s.filter[3].begin(FilterConfig(FILTER_PT1, 100), RATE);
+}
+
+void addFilters(Benchmark& bench)
+{
+  static const struct {
+    const char * name;
+    FilterConfig config;
+  } filters[] = {
+    { "filter_pt1",       FilterConfig(FILTER_PT1, 100) },
+    { "filter_biquad",    FilterConfig(FILTER_BIQUAD, 100) },
+    { "filter_pt2",       FilterConfig(FILTER_PT2, 100) },
+    { "filter_pt3",       FilterConfig(FILTER_PT3, 100) },
+    { "filter_notch",     FilterConfig(FILTER_NOTCH, 230, 150) },
+    { "filter_notch_df1", FilterConfig(FILTER_NOTCH_DF1, 230, 150) },
+    { "filter_bpf",       FilterConfig(FILTER_BPF, 180, 100) },
+    { "filter_fo",        FilterConfig(FILTER_FO, 100) },
+    { "filter_fir2",      FilterConfig(FILTER_FIR2, 100) },
+    { "filter_median3",   FilterConfig(FILTER_MEDIAN3, 100) },
+    { "filter_none",      FilterConfig(FILTER_NONE, 100) },
+  };
+  for(const auto& f: filters)
+  {
+    const FilterConfig config = f.config;
+    bench.add(f.name, [config](size_t n) {
+      Filter filter;
+      filter.begin(config, RATE);
+      float acc = 0;
+      for(size_t i = 0; i < n; i++) acc += filter.update(sample(i));
+      consume(acc);
+    });
+  }
+
+  // integer filters, host has fpu, so it only tracks regressions, gains show on fpu-less targets
+  for(const auto& f: filters)
+  {
+    const FilterConfig config = f.config;
+    bench.add(std::string("fixed_") + (f.name + 7), [config](size_t n) {
+      FilterFixed filter;
+      filter.begin(config, RATE);
+      int32_t acc = 0;
+      for(size_t i = 0; i < n; i++) acc += filter.updateFixed(sampleQ16(i));
+      consume(acc);
+    });
+  }
+
+  // three axes per op, Filter[3] compared to FilterBank3
+  for(const auto& f: filters)
+  {
+    const FilterConfig config = f.config;
+    bench.add(std::string("filter3_") + (f.name + 7), [config](size_t n) {
+      Filter filter[3];
+      for(size_t j = 0; j < 3; j++) filter[j].begin(config, RATE);
+      VectorFloat acc;
+      for(size_t i = 0; i < n; i++) acc += Utils::applyFilter(filter, VectorFloat(sample(i), sample(i + 1), sample(i + 2)));
+      consume(acc);
+    });
+    bench.add(std::string("bank3_") + (f.name + 7), [config](size_t n) {
+      FilterBank3 filter;
+      filter.begin(config, RATE);
+      VectorFloat acc;
+      for(size_t i = 0; i < n; i++) acc += filter.update(VectorFloat(sample(i), sample(i + 1), sample(i + 2)));
+      consume(acc);
+    });
+  }
+
+  // typical gyro chain: lpf2, two static notches, lpf, four dynamic notches
+  static const FilterConfig chain[] = {
+    FilterConfig(FILTER_PT1, 213), FilterConfig(FILTER_NOTCH, 300, 200), FilterConfig(FILTER_NOTCH, 200, 150), FilterConfig(FILTER_PT1, 100),
+    FilterConfig(FILTER_NOTCH_DF1, 400, 380), FilterConfig(FILTER_NOTCH_DF1, 350, 330), FilterConfig(FILTER_NOTCH_DF1, 250, 230), FilterConfig(FILTER_NOTCH_DF1, 230, 210),
+  };
+  static constexpr size_t CHAIN_LEN = sizeof(chain) / sizeof(chain[0]);
+  bench.add("gyro_chain_filter3", [](size_t n) {
+    Filter filter[CHAIN_LEN][3];
+    for(size_t c = 0; c < CHAIN_LEN; c++)
+    {
+      for(size_t j = 0; j < 3; j++) filter[c][j].begin(chain[c], RATE);
+    }
+    VectorFloat acc;
+    for(size_t i = 0; i < n; i++)
+    {
+      VectorFloat v(sample(i), sample(i + 1), sample(i + 2));
+      for(size_t c = 0; c < CHAIN_LEN; c++) v = Utils::applyFilter(filter[c], v);
+      acc += v;
+    }
+    consume(acc);
+  });
+  bench.add("gyro_chain_bank3", [](size_t n) {
+    FilterBank3 filter[CHAIN_LEN];
+    for(size_t c = 0; c < CHAIN_LEN; c++) filter[c].begin(chain[c], RATE);
+    VectorFloat acc;
+    for(size_t i = 0; i < n; i++)
+    {
+      VectorFloat v(sample(i), sample(i + 1), sample(i + 2));
+      for(size_t c = 0; c < CHAIN_LEN; c++) v = filter[c].update(v);
+      acc += v;
+    }
+    consume(acc);
+  });
+
+  // rpm filter, 4 motors x 3 harmonics x 3 axes
+  bench.add("rpm_filter_filter", [](size_t n) {
+    Filter filter[RpmFilter::MOTORS][RpmFilter::HARMONICS][3];
+    for(size_t m = 0; m < RpmFilter::MOTORS; m++)
+    {
+      for(size_t h = 0; h < RpmFilter::HARMONICS; h++)
+      {
+        const int freq = 150 + 40 * m + 200 * h;
+        for(size_t j = 0; j < 3; j++) filter[m][h][j].begin(FilterConfig(FILTER_NOTCH_DF1, freq, freq * 0.9f), RATE);
+      }
+    }
+    VectorFloat acc;
+    for(size_t i = 0; i < n; i++)
+    {
+      VectorFloat v(sample(i), sample(i + 1), sample(i + 2));
+      for(size_t m = 0; m < RpmFilter::MOTORS; m++)
+      {
+        for(size_t h = 0; h < RpmFilter::HARMONICS; h++) v = Utils::applyFilter(filter[m][h], v);
+      }
+      acc += v;
+    }
+    consume(acc);
+  });
+  bench.add("rpm_filter_bank", [](size_t n) {
+    RpmFilter filter;
+    filter.begin(RATE, RpmFilter::HARMONICS);
+    for(size_t m = 0; m < RpmFilter::MOTORS; m++)
+    {
+      for(size_t h = 0; h < RpmFilter::HARMONICS; h++) filter.reconfigure(m, h, 150 + 40 * m + 200 * h, 5.0f);
+    }
+    VectorFloat acc;
+    for(size_t i = 0; i < n; i++)
+    {
+      acc += filter.update(VectorFloat(sample(i), sample(i + 1), sample(i + 2)));
+    }
+    consume(acc);
+  });
+
+  // notch retune, as done by rpm and dynamic notch filters
+  bench.add("notch_coefs_exact", [](size_t n) {
+    FilterStateBiquad bq;
+    float acc = 0;
+    for(size_t i = 0; i < n; i++)
+    {
+      bq.init(BIQUAD_FILTER_NOTCH, RATE, 100 + (i & 1023) * 3, 5.0f);
+      acc += bq.a1;
+    }
+    consume(acc);
+  });
+  bench.add("notch_coefs_table", [](size_t n) {
+    FilterStateBiquad bq;
+    float acc = 0;
+    for(size_t i = 0; i < n; i++)
+    {
+      bq.initNotch(RATE, 100 + (i & 1023) * 3, 5.0f);
+      acc += bq.a1;
+    }
+    consume(acc);
+  });
+  bench.add("rpm_filter_bank_ramp", [](size_t n) {
+    RpmFilter filter;
+    filter.begin(RATE, RpmFilter::HARMONICS, 8);
+    VectorFloat acc;
+    for(size_t i = 0; i < n; i++)
+    {
+      // retune one stage per sample, so crossfade is always active
+      filter.reconfigure(i & 3, (i >> 2) % RpmFilter::HARMONICS, 150 + (i & 255), 5.0f);
+      acc += filter.update(VectorFloat(sample(i), sample(i + 1), sample(i + 2)));
+    }
+    consume(acc);
+  });
+  bench.add("rpm_filter_retune_all", [](size_t n) {
+    RpmFilter filter;
+    filter.begin(RATE, RpmFilter::HARMONICS);
+    for(size_t i = 0; i < n; i++)
+    {
+      const float motorFreq = 150 + (i & 255);
+      for(size_t m = 0; m < RpmFilter::MOTORS; m++)
+      {
+        for(size_t h = 0; h < RpmFilter::HARMONICS; h++) filter.reconfigure(m, h, (motorFreq + m) * (h + 1), 5.0f);
+      }
+    }
+    consume(filter);
+  });
+
+  bench.add("gyro_stages_runtime", [](size_t n) {
+    GyroStages stages;
+    initGyroStages(stages);
+    VectorFloat acc;
+    for(size_t i = 0; i < n; i++)
+    {
+      VectorFloat v(sample(i), sample(i + 1), sample(i + 2));
+      for(size_t c = 0; c < 4; c++) v = stages.filter[c].update(v);
+      acc += v;
+    }
+    consume(acc);
+  });
+  bench.add("gyro_stages_chain", [](size_t n) {
+    GyroStages stages;
+    initGyroStages(stages);
+    size_t mask = 0;
+    for(size_t c = 0; c < 4; c++)
+    {
+      if(stages.filter[c].type() != FILTER_NONE) mask |= 1 << c;
+    }
+    auto chain = FilterChainSelector<GyroStages, VectorFloat, GyroStagesChain, 4>::select(mask);
+    VectorFloat acc;
+    for(size_t i = 0; i < n; i++)
+    {
+      VectorFloat v(sample(i), sample(i + 1), sample(i + 2));
+      chain(stages, v);
+      acc += v;
+    }
+    consume(acc);
+  });
+
+  bench.add("apply_filter_vector", [](size_t n) {
+    Filter filter[3];
+    for(size_t j = 0; j < 3; j++) filter[j].begin(FilterConfig(FILTER_PT1, 100), RATE);
+    VectorFloat acc;
+    for(size_t i = 0; i < n; i++) acc += Utils::applyFilter(filter, VectorFloat(sample(i), sample(i + 1), sample(i + 2)));
+    consume(acc);
+  });
+}
+
+void setupPid(Control::Pid& pid)
+{
+  pid.rate = RATE;
+  pid.Kp = 0.1835f;
+  pid.Ki = 1.4002f;
+  pid.Kd = 0.0030f;
+  pid.Kf = 0.000788f;
+  pid.itermRelax = ITERM_RELAX_RP;
+  pid.dtermFilter.begin(FilterConfig(FILTER_PT1, 128), RATE);
+  pid.dtermFilter2.begin(FilterConfig(FILTER_PT1, 128), RATE);
+  pid.itermRelaxFilter.begin(FilterConfig(FILTER_PT1, 15), RATE);
+  pid.ftermFilter.begin(FilterConfig(FILTER_PT1, 30), RATE);
+  pid.begin();
+}
+
+void addControl(Benchmark& bench)
+{
+  bench.add("pid_update", [](size_t n) {
+    Control::Pid pid;
+    setupPid(pid);
+    float acc = 0;
+    for(size_t i = 0; i < n; i++) acc += pid.update(sample(i) * 0.01f, sample(i + 7) * 0.01f);
+    consume(acc);
+  });
+
+  // op is roll, pitch and yaw update
+  bench.add("pid_update_x3", [](size_t n) {
+    Control::Pid pids[3];
+    for(Control::Pid& pid: pids) setupPid(pid);
+    float acc = 0;
+    for(size_t i = 0; i < n; i++)
+    {
+      for(size_t j = 0; j < 3; j++) acc += pids[j].update(sample(i + j) * 0.01f, sample(i + j + 7) * 0.01f);
+    }
+    consume(acc);
+  });
+
+  // same work as pid_update_x3
+  bench.add("pid3_update", [](size_t n) {
+    Control::Pid pids[3];
+    for(Control::Pid& pid: pids) setupPid(pid);
+    Control::Pid3 pid3(pids);
+    float acc = 0;
+    for(size_t i = 0; i < n; i++)
+    {
+      const float setpoint[] = { sample(i) * 0.01f, sample(i + 1) * 0.01f, sample(i + 2) * 0.01f };
+      const float measurement[] = { sample(i + 7) * 0.01f, sample(i + 8) * 0.01f, sample(i + 9) * 0.01f };
+      float output[3];
+      pid3.update(setpoint, measurement, output);
+      acc += output[0] + output[1] + output[2];
+    }
+    consume(acc);
+  });
+
+  static const char * rateNames[] = { "rates_betaflight", "rates_raceflight", "rates_kiss", "rates_actual", "rates_quick" };
+  for(int type = RATES_TYPE_BETAFLIGHT; type <= RATES_TYPE_QUICK; type++)
+  {
+    bench.add(rateNames[type], [type](size_t n) {
+      ModelConfig config;
+      config.input.rateType = type;
+      Rates rates;
+      rates.begin(config.input);
+      float acc = 0;
+      for(size_t i = 0; i < n; i++) acc += rates.getSetpoint(i % 3, sample(i) * 0.01f);
+      consume(acc);
+    });
+  }
+
+  // curve evaluation used to build rate tables
+  bench.add("rates_exact", [](size_t n) {
+    ModelConfig config;
+    Rates rates;
+    rates.begin(config.input);
+    float acc = 0;
+    for(size_t i = 0; i < n; i++) acc += rates.getSetpointExact(i % 3, sample(i) * 0.01f);
+    consume(acc);
+  });
+
+  static const MixerType mixerTypes[] = { FC_MIXER_QUADX, FC_MIXER_TRI, FC_MIXER_CUSTOM_AIRPLANE };
+  static const char * const mixerNames[] = { "mixer_update_quadx", "mixer_update_tri", "mixer_update_custom_plane" };
+  for(size_t t = 0; t < 3; t++)
+  {
+    const MixerType type = mixerTypes[t];
+    bench.add(mixerNames[t], [type](size_t n) {
+      static Model model;
+      // motor, ailerons and elevator with rc pass-through and aux flaps
+      const MixerEntry plane[] = {
+        MixerEntry(MIXER_SOURCE_THRUST, 0, 100),
+        MixerEntry(MIXER_SOURCE_ROLL, 1, 100), MixerEntry(MIXER_SOURCE_RC_ROLL, 1, 50), MixerEntry(MIXER_SOURCE_RC_AUX1, 1, 30),
+        MixerEntry(MIXER_SOURCE_ROLL, 2, 100), MixerEntry(MIXER_SOURCE_RC_ROLL, 2, 50), MixerEntry(MIXER_SOURCE_RC_AUX1, 2, -30),
+        MixerEntry(MIXER_SOURCE_PITCH, 3, 100), MixerEntry(MIXER_SOURCE_RC_PITCH, 3, 50), MixerEntry(MIXER_SOURCE_YAW, 3, 20),
+        MixerEntry(),
+      };
+      std::copy(plane, plane + sizeof(plane) / sizeof(plane[0]), model.config.customMixes);
+      model.state.customMixer = MixerConfig(4, model.config.customMixes);
+      model.state.currentMixer = Output::Mixers::getMixer(type, model.state.customMixer);
+      Output::Mixer mixer(model);
+      Output::MixerMatrix matrix;
+      matrix.compile(model.state.currentMixer);
+      float outputs[OUTPUT_CHANNELS];
+      float acc = 0;
+      for(size_t i = 0; i < n; i++)
+      {
+        model.state.output[AXIS_ROLL] = sample(i) * 0.01f;
+        model.state.output[AXIS_THRUST] = 0.5f;
+        mixer.updateMixer(matrix, outputs);
+        acc += outputs[i & 3];
+      }
+      consume(acc);
+    });
+  }
+
+  // thrust linearization and sag compensation, table vs curve
+  bench.add("output_curve_apply", [](size_t n) {
+    ModelConfig config;
+    config.output.thrustLinear = 40;
+    config.output.vbatSagCompensation = 100;
+    Output::OutputCurve curve;
+    curve.begin(config.output, 3.8f);
+    float acc = 0;
+    for(size_t i = 0; i < n; i++)
+    {
+      float outputs[OUTPUT_CHANNELS] = { sample(i) * 0.01f, sample(i + 1) * 0.01f, sample(i + 2) * 0.01f, sample(i + 3) * 0.01f };
+      curve.apply(outputs, 4);
+      acc += outputs[i & 3];
+    }
+    consume(acc);
+  });
+
+  bench.add("output_curve_exact", [](size_t n) {
+    ModelConfig config;
+    config.output.thrustLinear = 40;
+    config.output.vbatSagCompensation = 100;
+    Output::OutputCurve curve;
+    curve.begin(config.output, 3.8f);
+    float acc = 0;
+    for(size_t i = 0; i < n; i++)
+    {
+      for(size_t c = 0; c < 4; c++) acc += curve.getExact(c, sample(i + c) * 0.01f);
+    }
+    consume(acc);
+  });
+}
+
+void addProtocols(Benchmark& bench)
+{
+  bench.add("crsf_decode_rc_shift8", [](size_t n) {
+    const uint8_t data[] = {
+      0xE0, 0x03, 0xDF, 0xD9, 0xC0, 0xF7, 0x8B, 0x5F, 0x94, 0xAF, 0x7C,
+      0xE5, 0x2B, 0x5F, 0xF9, 0xCA, 0x07, 0x00, 0x00, 0x4C, 0x7C, 0xE2,
+    };
+    Rc::CrsfData frame;
+    std::memcpy(&frame, data, sizeof(frame));
+    uint16_t channels[16];
+    uint32_t acc = 0;
+    for(size_t i = 0; i < n; i++)
+    {
+      Rc::Crsf::decodeRcDataShift8(channels, &frame);
+      acc += channels[i & 15];
+    }
+    consume(acc);
+  });
+
+  // op is one received byte
+  bench.add("msp_parse_byte", [](size_t n) {
+    uint8_t frame[6 + 16];
+    const uint8_t header[] = { '$', 'M', '<', 16, 200 };
+    std::memcpy(frame, header, sizeof(header));
+    uint8_t checksum = 16 ^ 200;
+    for(size_t i = 0; i < 16; i++)
+    {
+      frame[5 + i] = i;
+      checksum ^= i;
+    }
+    frame[sizeof(frame) - 1] = checksum;
+
+    Msp::MspParser parser;
+    Msp::MspMessage msg;
+    uint32_t acc = 0;
+    for(size_t i = 0; i < n; i++)
+    {
+      parser.parse(frame[i % sizeof(frame)], msg);
+      if(msg.state == Msp::MSP_STATE_RECEIVED)
+      {
+        acc += msg.cmd;
+        msg.state = Msp::MSP_STATE_IDLE;
+      }
+    }
+    consume(acc);
+  });
+
+  // op is one byte
+  bench.add("crc8_dvb_s2_byte", [](size_t n) {
+    uint8_t crc = 0;
+    for(size_t i = 0; i < n; i++) crc = Math::crc8_dvb_s2(crc, (uint8_t)i);
+    consume(crc);
+  });
+
+  // four motors per loop, per channel convert and checksum loop vs folded frame
+  bench.add("dshot_encode_x4", [](size_t n) {
+    uint32_t acc = 0;
+    for(size_t i = 0; i < n; i++)
+    {
+      for(size_t c = 0; c < 4; c++)
+      {
+        const int pulse = constrain(1000 + (int)((i + c * 97) & 1023), 0, 2000);
+        acc += EscDriver::dshotEncode(EscDriver::dshotConvert(pulse), c & 1);
+      }
+    }
+    consume(acc);
+  });
+
+  bench.add("dshot_frame_x4", [](size_t n) {
+    uint32_t acc = 0;
+    for(size_t i = 0; i < n; i++)
+    {
+      for(size_t c = 0; c < 4; c++)
+      {
+        acc += EscDriver::dshotFrame(1000 + (int)((i + c * 97) & 1023), c & 1);
+      }
+    }
+    consume(acc);
+  });
+
+  bench.add("gcr_to_raw_value", [](size_t n) {
+    static const uint32_t values[] = { 0b011010011101101100101, 0b011010011101001110001, 0b011010011100110110011, 0b001010010100101010001 };
+    uint32_t acc = 0;
+    for(size_t i = 0; i < n; i++) acc += EscDriver::gcrToRawValue(values[i & 3]);
+    consume(acc);
+  });
+
+  bench.add("extract_telemetry_gcr", [](size_t n) {
+    auto item = [](uint32_t d0, uint32_t l0, uint32_t d1, uint32_t l1) -> uint32_t {
+      return (d0 & 0x07fff) | (l0 & 0x1) << 15 | (d1 & 0x07fff) << 16 | (l1 & 0x1) << 31;
+    };
+    uint32_t data[] = {
+      item(100, 0, 200, 1), item(100, 0, 100, 1), item(200, 0, 300, 1),
+      item(100, 0, 200, 1), item(100, 0, 200, 1), item(200, 0, 100, 1),
+      item(100, 0,   0, 0),
+    };
+    uint32_t acc = 0;
+    for(size_t i = 0; i < n; i++) acc += EscDriver::extractTelemetryGcr(data, sizeof(data), 100);
+    consume(acc);
+  });
+
+  // op is one captured dshot300 frame from docs/dshot_gcr_dump.txt, extract and decode
+  bench.add("gcr_decode_dump", [](size_t n) {
+    auto item = [](uint32_t d0, uint32_t l0, uint32_t d1, uint32_t l1) -> uint32_t {
+      return (d0 & 0x07fff) | (l0 & 0x1) << 15 | (d1 & 0x07fff) << 16 | (l1 & 0x1) << 31;
+    };
+    uint32_t frames[2][8] = {
+      {
+        item(381, 0, 165, 1), item(172, 0, 172, 1), item(377, 0, 176, 1), item(165, 0, 171, 1),
+        item(381, 0, 169, 1), item(168, 0, 172, 1), item(175, 0, 172, 1), item(593, 0,   0, 0),
+      },
+      {
+        item(381, 0, 172, 1), item(171, 0, 165, 1), item(385, 0, 168, 1), item(168, 0, 169, 1),
+        item(381, 0, 169, 1), item(178, 0, 162, 1), item(175, 0, 171, 1), item(607, 0,   0, 0),
+      },
+    };
+    uint32_t acc = 0;
+    for(size_t i = 0; i < n; i++)
+    {
+      acc += EscDriver::gcrToRawValue(EscDriver::extractTelemetryGcr(frames[i & 1], 8, 213));
+    }
+    consume(acc);
+  });
+}
+
+void addAnalyzers(Benchmark& bench)
+{
+  bench.add("freq_analyzer_update", [](size_t n) {
+    Math::FreqAnalyzer analyzer;
+    analyzer.begin(RATE, DynamicFilterConfig(4, 300, 80, 400));
+    for(size_t i = 0; i < n; i++) analyzer.update(sample(i));
+    consume(analyzer.freq);
+  });
+
+  // op is one 64 bin spectrum scan
+  bench.add("peak_detect_64", [](size_t n) {
+    float spectrum[64];
+    for(size_t i = 0; i < 64; i++) spectrum[i] = std::abs(samples[i * 7]);
+    Math::Peak peaks[4];
+    float acc = 0;
+    for(size_t i = 0; i < n; i++)
+    {
+      for(size_t j = 0; j < 4; j++) peaks[j] = Math::Peak();
+      Math::peakDetect(spectrum, 1, 62, (float)RATE / 128, peaks, 4);
+      Math::peakSort(peaks, 4);
+      acc += peaks[0].freq;
+    }
+    consume(acc);
+  });
+
+  // op is one gyro sample, same cost for every sample
+  bench.add("sdft_analyzer_update", [](size_t n) {
+    static Math::SdftAnalyzer<128> analyzer;
+    analyzer.begin(RATE, DynamicFilterConfig(4, 300, 80, 400), 0);
+    int acc = 0;
+    for(size_t i = 0; i < n; i++) acc += analyzer.update(sample(i));
+    consume(acc);
+  });
+
+  // op is one gyro sample, analysis is spread over consecutive samples by work budget
+  bench.add("fft_analyzer_update", [](size_t n) {
+    static Math::FFTAnalyzer<128> analyzer;
+    analyzer.begin(RATE, DynamicFilterConfig(4, 300, 80, 400), 0);
+    int acc = 0;
+    for(size_t i = 0; i < n; i++) acc += analyzer.update(sample(i));
+    consume(acc);
+  });
+
+  // op is one 128 sample real transform
+  bench.add("fft_real_128", [](size_t n) {
+    float data[128];
+    Math::FFTReal<128>::begin();
+    float acc = 0;
+    for(size_t i = 0; i < n; i++)
+    {
+      for(size_t j = 0; j < 128; j++) data[j] = sample(i + j);
+      Math::FFTReal<128>::forward(data);
+      acc += data[10];
+    }
+    consume(acc);
+  });
+
+#ifdef ESPFC_DSP
+  // esp-dsp reference for fft_real_128
+  bench.add("fft_dsps_128", [](size_t n) {
+    __attribute__((aligned(16))) float data[128];
+    dsps_fft4r_init_fc32(nullptr, 64);
+    float acc = 0;
+    for(size_t i = 0; i < n; i++)
+    {
+      for(size_t j = 0; j < 128; j++) data[j] = sample(i + j);
+      dsps_fft4r_fc32(data, 64);
+      dsps_bit_rev4r_fc32(data, 64);
+      dsps_cplx2real_fc32(data, 64);
+      acc += data[10];
+    }
+    consume(acc);
+  });
+#endif
+}
+
+// spins shortly, then lets other thread run if host has fewer cores
+template<typename T>
+void waitFor(SeqLock<T>& channel, T& item)
+{
+  for(size_t i = 0; !channel.receive(item); i++)
+  {
+    if(i >= 64) std::this_thread::yield();
+  }
+}
+
+void addTasks(Benchmark& bench)
+{
+  // gyro task side, never waits for reader
+  bench.add("seqlock_write", [](size_t n) {
+    SeqLock<GyroSample> channel;
+    GyroSample s{};
+    for(size_t i = 0; i < n; i++)
+    {
+      s.gyro.x = sample(i);
+      s.timestamp = i;
+      channel.write(s);
+    }
+    consume(channel.version());
+  });
+
+  bench.add("seqlock_read", [](size_t n) {
+    SeqLock<GyroSample> channel;
+    channel.write(GyroSample{VectorFloat(1.f, 2.f, 3.f), 4});
+    GyroSample s{};
+    uint32_t acc = 0;
+    for(size_t i = 0; i < n; i++) acc += channel.read(s) + s.timestamp;
+    consume(acc);
+  });
+
+  // op is one sample passed to other thread and back, latency between cores
+  bench.add("seqlock_round_trip", [](size_t n) {
+    SeqLock<GyroSample> ping, pong;
+    std::thread echo([&ping, &pong, n]() {
+      GyroSample s;
+      for(size_t i = 0; i < n; i++)
+      {
+        waitFor(ping, s);
+        pong.write(s);
+      }
+    });
+    GyroSample s{}, r{};
+    for(size_t i = 0; i < n; i++)
+    {
+      s.timestamp = i;
+      ping.write(s);
+      waitFor(pong, r);
+    }
+    echo.join();
+    consume(r.timestamp);
+  });
+
+  // cost of one measurement, sum and count plus histogram
+  bench.add("stats_add", [](size_t n) {
+    Stats stats;
+    for(size_t i = 0; i < n; i++)
+    {
+      stats.add(COUNTER_GYRO_READ, 5 + (i & 15) + ((i & 1023) == 0) * 80);
+    }
+    consume(stats.getSamples(COUNTER_GYRO_READ));
+  });
+
+  // scoped measurement, two timebase reads plus add
+  bench.add("stats_measure", [](size_t n) {
+    Stats stats;
+    stats.begin(targetCycleFreq());
+    for(size_t i = 0; i < n; i++)
+    {
+      Stats::Measure measure(stats, COUNTER_GYRO_FILTER);
+    }
+    consume(stats.getSamples(COUNTER_GYRO_FILTER));
+  });
+}
+
+struct BenchOptions
+{
+  const char * filter = nullptr;
+  const char * json = nullptr;
+  const char * baseline = nullptr;
+  float threshold = 10.f;
+};
+
+BenchOptions parseOptions(int argc, char ** argv)
+{
+  BenchOptions opt;
+  for(int i = 1; i < argc; i++)
+  {
+    if(std::strcmp(argv[i], "-f") == 0 && i + 1 < argc) opt.filter = argv[++i];
+    else if(std::strcmp(argv[i], "-j") == 0 && i + 1 < argc) opt.json = argv[++i];
+    else if(std::strcmp(argv[i], "-b") == 0 && i + 1 < argc) opt.baseline = argv[++i];
+    else if(std::strcmp(argv[i], "-t") == 0 && i + 1 < argc) opt.threshold = std::atof(argv[++i]);
+    else
+    {
+      std::printf("usage: %s [-f filter] [-j out.json] [-b baseline.json] [-t threshold_percent]\n", argv[0]);
+      std::exit(1);
+    }
+  }
+  return opt;
+}
+
+}
+
+int main(int argc, char ** argv)
+{
+  const BenchOptions opt = parseOptions(argc, argv);
+
+  benchInitFakes();
+  initSamples();
+
+  Benchmark bench;
+  bench.setFilter(opt.filter);
+  bench.setIdle(benchResetFakes);
+  addFilters(bench);
+  addControl(bench);
+  addProtocols(bench);
+  addAnalyzers(bench);
+  addTasks(bench);
+
+  bench.run();
+
+  if(opt.baseline && !bench.loadBaseline(opt.baseline))
+  {
+    std::printf("bench: can't read baseline %s\n", opt.baseline);
+    return 2;
+  }
+  bench.print();
+
+  if(opt.json && !bench.writeJson(opt.json))
+  {
+    std::printf("bench: can't write %s\n", opt.json);
+    return 2;
+  }
+
+  if(opt.baseline)
+  {
+    const size_t count = bench.regressions(opt.threshold);
+    if(count)
+    {
+      std::printf("bench: %zu kernel(s) regressed more than %.1f%%\n", count, opt.threshold);
+      return 1;
+    }
+  }
+
+  return 0;
+}
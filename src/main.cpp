@@ -27,6 +27,8 @@ void IRAM_ATTR serialEventRun(void) {}
 Espfc::Espfc espfc;
 
 #if defined(ESPFC_MULTI_CORE)
+  static const uint32_t OTHER_TASK_TIMEOUT = 100000; // us
+
   #if defined(ESPFC_FREE_RTOS)
 
     // ESP32 multicore
@@ -79,7 +81,7 @@ Espfc::Espfc espfc;
     {
       while(true)
       {
-        espfc.updateOther();
+        espfc.updateOther(OTHER_TASK_TIMEOUT); // sleep until gyro task sends event, core 0 is free for wifi
       }
     }
 
@@ -116,7 +118,7 @@ Espfc::Espfc espfc;
     }
     void loop1()
     {
-      espfc.updateOther();
+      espfc.updateOther(OTHER_TASK_TIMEOUT); // sleep until gyro core sends event
     }
 
   #else
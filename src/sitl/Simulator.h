@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cmath>
+#include <random>
+#include <EscDriver.h>
+#include <helper_3dmath.h>
+#include "Model.h"
+#include "Device/BusSitl.h"
+#include "Device/InputSitl.h"
+
+namespace Espfc {
+
+namespace Sitl {
+
+/**
+ * Minimal rigid body simulation for software-in-the-loop runs.
+ * Motor speeds are taken from EscDriverSitl, torques are derived from active mixer,
+ * resulting angular rates with motor noise are injected to simulated MPU6500 registers.
+ */
+class Simulator
+{
+  public:
+    static constexpr uint8_t MPU_WHOAMI_REG = 0x75;
+    static constexpr uint8_t MPU_WHOAMI_VALUE = 0x70;
+    static constexpr uint8_t MPU_ACCEL_REG = 0x3B;
+    static constexpr uint8_t MPU_GYRO_REG = 0x43;
+    static constexpr float GYRO_LSB = 32768.f / 2000.f; // 2000 dps range
+    static constexpr float ACCEL_LSB = 32768.f / 16.f;  // 16 g range
+    static constexpr float TORQUE_GAIN = 5000.f; // dps/s per unit of thrust
+    static constexpr float DRAG = 2.f;
+    static constexpr float MOTOR_NOISE = 20.f; // dps at full thrust
+    static constexpr float GYRO_NOISE = 0.5f;  // dps
+    static constexpr uint32_t RX_INTERVAL = 4000; // 250Hz rx frame rate
+
+    Simulator(Model& model, uint32_t seed): _model(model), _rng(seed), _noise(0.f, 1.f), _rxNext(0)
+    {
+      for(size_t i = 0; i < OUTPUT_CHANNELS; i++)
+      {
+        _thrust[i] = 0;
+        _phase[i] = 0;
+      }
+    }
+
+    void begin()
+    {
+      const uint8_t whoami = MPU_WHOAMI_VALUE;
+      Device::BusSitl::poke(MPU_WHOAMI_REG, &whoami, 1);
+      writeSensors();
+    }
+
+    void update(uint32_t now, float dt)
+    {
+      updateBody(dt);
+      writeSensors();
+      if(now >= _rxNext)
+      {
+        _rxNext = now + RX_INTERVAL;
+        sendInput(now * 0.000001f);
+      }
+    }
+
+    const VectorFloat& rate() const
+    {
+      return _rate;
+    }
+
+  private:
+    void updateBody(float dt)
+    {
+      EscDriverSitl * esc = EscDriverSitl::instance(ESC_DRIVER_MOTOR_TIMER);
+      const MixerConfig& mixer = _model.state.currentMixer;
+      const float poleRatio = 100.f / 60.f / (_model.config.output.motorPoles * 0.5f);
+
+      VectorFloat torque;
+      for(size_t i = 0; i < OUTPUT_CHANNELS; i++)
+      {
+        _thrust[i] = 0;
+        if(!esc) continue;
+        float speed = esc->erpm(i) / EscDriverSitl::ERPM_MAX;
+        _thrust[i] = speed * speed;
+        _phase[i] = std::fmod(_phase[i] + esc->erpm(i) * poleRatio * dt * 2.f * (float)M_PI, 2.f * (float)M_PI);
+      }
+      for(size_t i = 0; i < MIXER_RULE_MAX && mixer.mixes; i++)
+      {
+        const MixerEntry& entry = mixer.mixes[i];
+        if(entry.src == MIXER_SOURCE_NULL) break;
+        if(entry.src < MIXER_SOURCE_ROLL || entry.src > MIXER_SOURCE_YAW) continue;
+        if(entry.dst < 0 || entry.dst >= (int)OUTPUT_CHANNELS) continue;
+        const size_t axis = entry.src - MIXER_SOURCE_ROLL;
+        // yaw reaction torque acts against motor rotation
+        const float sign = axis == AXIS_YAW ? -1.f : 1.f;
+        torque.set(axis, torque[axis] + sign * entry.rate * 0.01f * _thrust[entry.dst]);
+      }
+      _rate += (torque * TORQUE_GAIN - _rate * DRAG) * dt;
+    }
+
+    void writeSensors()
+    {
+      VectorFloat gyro = _rate;
+      for(size_t i = 0; i < OUTPUT_CHANNELS; i++)
+      {
+        // fundamental and second harmonic of each motor, different phase on each axis
+        float amp = MOTOR_NOISE * _thrust[i];
+        gyro.x += amp * (std::sin(_phase[i]) + 0.5f * std::sin(2.f * _phase[i]));
+        gyro.y += amp * (std::cos(_phase[i]) + 0.5f * std::cos(2.f * _phase[i]));
+        gyro.z += amp * 0.3f * std::sin(_phase[i] + 1.f);
+      }
+      gyro += VectorFloat(_noise(_rng), _noise(_rng), _noise(_rng)) * GYRO_NOISE;
+      VectorFloat accel(0.f, 0.f, 1.f);
+      accel += VectorFloat(_noise(_rng), _noise(_rng), _noise(_rng)) * 0.01f;
+
+      writeVector(MPU_GYRO_REG, gyro * GYRO_LSB);
+      writeVector(MPU_ACCEL_REG, accel * ACCEL_LSB);
+    }
+
+    void writeVector(uint8_t reg, const VectorFloat& v)
+    {
+      uint8_t buff[6];
+      for(size_t i = 0; i < 3; i++)
+      {
+        int16_t value = (int16_t)std::max(-32768.f, std::min(32767.f, std::round(v[i])));
+        buff[i * 2] = (uint16_t)value >> 8;
+        buff[i * 2 + 1] = (uint16_t)value & 0xff;
+      }
+      Device::BusSitl::poke(reg, buff, sizeof(buff));
+    }
+
+    /**
+     * Flight script: calibrate, arm with throttle low, then hover with stick sweeps.
+     */
+    void sendInput(float t)
+    {
+      int16_t axes[AXIS_COUNT];
+      for(size_t i = 0; i < AXIS_COUNT; i++) axes[i] = 1500;
+      axes[AXIS_THRUST] = 1000;
+      axes[AXIS_AUX_1] = t >= 3.0f ? 1500 : 1000;
+      if(t >= 3.5f)
+      {
+        float s = t - 3.5f;
+        axes[AXIS_THRUST] = 1450;
+        axes[AXIS_ROLL] = 1500 + lrintf(150.f * std::sin(2.f * (float)M_PI * 0.5f * s));
+        axes[AXIS_PITCH] = 1500 + lrintf(100.f * std::sin(2.f * (float)M_PI * 0.7f * s));
+        axes[AXIS_YAW] = 1500 + lrintf(80.f * std::sin(2.f * (float)M_PI * 0.3f * s));
+      }
+
+      // apply receiver channel map
+      uint16_t channels[Device::InputSitl::CHANNELS];
+      for(size_t i = 0; i < Device::InputSitl::CHANNELS; i++) channels[i] = 1500;
+      for(size_t i = 0; i < AXIS_COUNT; i++)
+      {
+        size_t ch = _model.config.input.channel[i].map;
+        if(ch < Device::InputSitl::CHANNELS) channels[ch] = axes[i];
+      }
+      Device::InputSitl::send(channels, Device::InputSitl::CHANNELS);
+    }
+
+    Model& _model;
+    std::mt19937 _rng;
+    std::normal_distribution<float> _noise;
+    uint32_t _rxNext;
+    VectorFloat _rate; // dps
+    float _thrust[OUTPUT_CHANNELS];
+    float _phase[OUTPUT_CHANNELS];
+};
+
+}
+
+}
@@ -0,0 +1,200 @@
+// Software-in-the-loop entry point, runs full Espfc loop on host with simulated devices.
+// build: pio run -e sitl
+// run:   .pio/build/sitl/program [-d seconds] [-l loop_sync] [-s seed] [-v]
+
+#include <ArduinoFake.h>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <Espfc.h>
+#include "Simulator.h"
+
+using namespace fakeit;
+
+namespace {
+
+// virtual clock: timers observe simulated time, while time spent inside a simulation step
+// is taken from host clock, so Stats counters report real execution cost
+uint32_t simTime = 0;
+uint32_t lastTime = 0;
+std::chrono::steady_clock::time_point stepStart;
+
+unsigned long sitlMicros()
+{
+  uint32_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - stepStart).count();
+  uint32_t now = simTime + elapsed;
+  if((int32_t)(now - lastTime) > 0) lastTime = now;
+  return lastTime;
+}
+
+void sitlInitFakes()
+{
+  When(Method(ArduinoFake(), micros)).AlwaysDo([]() -> unsigned long { return sitlMicros(); });
+  When(Method(ArduinoFake(), millis)).AlwaysDo([]() -> unsigned long { return sitlMicros() / 1000; });
+  When(Method(ArduinoFake(), delay)).AlwaysReturn();
+  When(Method(ArduinoFake(), delayMicroseconds)).AlwaysReturn();
+  When(Method(ArduinoFake(), yield)).AlwaysReturn();
+  When(Method(ArduinoFake(), pinMode)).AlwaysReturn();
+  When(Method(ArduinoFake(), digitalWrite)).AlwaysReturn();
+  When(Method(ArduinoFake(), digitalRead)).AlwaysReturn(0);
+  When(Method(ArduinoFake(), analogRead)).AlwaysReturn(0);
+}
+
+void sitlResetFakes()
+{
+  // fakes record every invocation, reset them periodically to keep memory bounded
+  ArduinoFakeReset();
+  sitlInitFakes();
+}
+
+struct SitlOptions
+{
+  float duration = 10.f;
+  int loopSync = 0;
+  uint32_t seed = 1;
+  bool verbose = false;
+};
+
+SitlOptions parseOptions(int argc, char ** argv)
+{
+  SitlOptions opt;
+  for(int i = 1; i < argc; i++)
+  {
+    if(std::strcmp(argv[i], "-d") == 0 && i + 1 < argc) opt.duration = std::atof(argv[++i]);
+    else if(std::strcmp(argv[i], "-l") == 0 && i + 1 < argc) opt.loopSync = std::atoi(argv[++i]);
+    else if(std::strcmp(argv[i], "-s") == 0 && i + 1 < argc) opt.seed = std::atoi(argv[++i]);
+    else if(std::strcmp(argv[i], "-v") == 0) opt.verbose = true;
+    else
+    {
+      std::printf("usage: %s [-d seconds] [-l loop_sync] [-s seed] [-v]\n", argv[0]);
+      std::exit(1);
+    }
+  }
+  return opt;
+}
+
+void configure(Espfc::Model& model, const SitlOptions& opt)
+{
+  model.config.output.protocol = ESC_PROTOCOL_DSHOT600;
+  model.config.output.dshotTelemetry = true;
+  model.config.featureMask |= Espfc::FEATURE_DYNAMIC_FILTER;
+  if(opt.loopSync > 0) model.config.loopSync = opt.loopSync;
+
+  model.config.conditions[0].id = Espfc::MODE_ARMED;
+  model.config.conditions[0].ch = Espfc::AXIS_AUX_1 + 0;
+  model.config.conditions[0].min = 1300;
+  model.config.conditions[0].max = 2100;
+  model.config.conditions[0].logicMode = 0;
+  model.config.conditions[0].linkId = 0;
+}
+
+float percentile(std::vector<uint32_t>& v, float p)
+{
+  if(v.empty()) return 0;
+  size_t n = std::min(v.size() - 1, (size_t)(p * 0.01f * v.size()));
+  std::nth_element(v.begin(), v.begin() + n, v.end());
+  return v[n];
+}
+
+}
+
+int main(int argc, char ** argv)
+{
+  const SitlOptions opt = parseOptions(argc, argv);
+
+  stepStart = std::chrono::steady_clock::now();
+  sitlInitFakes();
+
+  // static storage is zero initialized, like global instance on hardware
+  static Espfc::Espfc espfc;
+  Espfc::Model& model = espfc.getModel();
+  Espfc::Sitl::Simulator sim(model, opt.seed);
+
+  sim.begin();
+  espfc.load();
+  configure(model, opt);
+  espfc.begin();
+
+  if(opt.verbose) std::printf("%s", model.logger.c_str());
+  if(!model.state.gyroPresent)
+  {
+    std::printf("sitl: gyro not detected\n");
+    return 1;
+  }
+
+  const uint32_t interval = espfc.getGyroInterval();
+  const float dt = interval * 0.000001f;
+  const uint64_t steps = (uint64_t)(opt.duration * 1e6f / interval);
+  const uint32_t resetSteps = model.state.gyroTimer.rate;
+
+  std::vector<uint32_t> cost;
+  cost.reserve(steps);
+  uint64_t costSum = 0;
+  uint32_t overruns = 0;
+  uint32_t armedSteps = 0;
+  float trackingError[3] = { 0, 0, 0 };
+
+  for(uint64_t i = 0; i < steps; i++)
+  {
+    simTime += interval;
+    stepStart = std::chrono::steady_clock::now();
+    sim.update(simTime, dt);
+
+    // gyro timer triggers update, then pending events are consumed, like gyroTask and pidTask on multi core targets
+    auto start = std::chrono::steady_clock::now();
+    espfc.update(true);
+    while(espfc.updateOther()) {}
+    uint32_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    cost.push_back(ns);
+    costSum += ns;
+    if(ns > interval * 1000) overruns++;
+
+    if(model.isModeActive(Espfc::MODE_ARMED))
+    {
+      armedSteps++;
+      for(size_t j = 0; j < 3; j++)
+      {
+        float err = Espfc::Math::toDeg(model.state.desiredRate[j]) - sim.rate()[j];
+        trackingError[j] += err * err;
+      }
+    }
+
+    if(resetSteps && (i + 1) % resetSteps == 0) sitlResetFakes();
+  }
+
+  EscDriverSitl * esc = EscDriverSitl::instance(ESC_DRIVER_MOTOR_TIMER);
+
+  std::printf("sitl: %.2fs simulated, %llu steps, seed %u\n", opt.duration, (unsigned long long)steps, opt.seed);
+  std::printf("rate: gyro %d Hz, loop %d Hz, mixer %d Hz, input %d Hz\n",
+    model.state.gyroTimer.rate, model.state.loopTimer.rate, model.state.mixerTimer.rate, model.state.inputTimer.rate);
+  std::printf("slots: gyro %u, loop %u, esc %u\n",
+    model.state.gyroTimer.iteration, model.state.loopTimer.iteration, esc ? esc->applyCount() : 0);
+  std::printf("update: avg %.0f ns, p50 %.0f ns, p99 %.0f ns, max %.0f ns, overruns %u\n",
+    steps ? (float)costSum / steps : 0.f, percentile(cost, 50), percentile(cost, 99), percentile(cost, 100), overruns);
+  std::printf("armed: %.2fs, arming disabled 0x%08x, rate error rms [dps]: %.2f %.2f %.2f\n",
+    armedSteps * dt, model.state.armingDisabledFlags,
+    armedSteps ? std::sqrt(trackingError[0] / armedSteps) : 0.f,
+    armedSteps ? std::sqrt(trackingError[1] / armedSteps) : 0.f,
+    armedSteps ? std::sqrt(trackingError[2] / armedSteps) : 0.f);
+  if(esc)
+  {
+    std::printf("motors [erpm/100]:");
+    for(size_t i = 0; i < ESC_CHANNEL_COUNT; i++) std::printf(" %.0f", esc->erpm(i));
+    std::printf("\n");
+  }
+
+  std::printf("stats: name time[us] load[%%] freq[Hz] real[us]\n");
+  for(int i = 0; i < Espfc::COUNTER_COUNT; i++)
+  {
+    Espfc::StatCounter c = (Espfc::StatCounter)i;
+    if(!model.state.stats.getFreq(c)) continue;
+    std::printf("%s %8.2f %6.1f %6.0f %8.2f\n", model.state.stats.getName(c),
+      model.state.stats.getTime(c), model.state.stats.getLoad(c), model.state.stats.getFreq(c), model.state.stats.getReal(c));
+  }
+
+  return 0;
+}
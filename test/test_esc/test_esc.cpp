@@ -43,6 +43,16 @@ void test_esc_dshot_convert()
   TEST_ASSERT_EQUAL_UINT16(2047, EscDriver::dshotConvert(2000));
 }
 
+void test_esc_dshot_frame_matches_encode()
+{
+  for(int pulse = -100; pulse <= 2100; pulse++)
+  {
+    const uint16_t value = EscDriver::dshotConvert(constrain(pulse, 0, 2000));
+    TEST_ASSERT_EQUAL_UINT16(EscDriver::dshotEncode(value, false), EscDriver::dshotFrame(pulse, false));
+    TEST_ASSERT_EQUAL_UINT16(EscDriver::dshotEncode(value, true), EscDriver::dshotFrame(pulse, true));
+  }
+}
+
 void test_esc_gcr_to_raw_value()
 {
   TEST_ASSERT_EQUAL_UINT32(1942, EscDriver::gcrToRawValue(0b011010011101101100101));
@@ -248,12 +258,158 @@ void test_esc_extract_telemetry_dshot300_idle()
   TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, rpm);
 }
 
+// reference decoder, bit by bit as before run length thresholds and table reject
+static uint32_t referenceExtractGcr(const uint32_t * data, size_t len, uint32_t bitLen)
+{
+  int bitCount = 0;
+  uint32_t value = 0;
+  for(size_t i = 0; i < len; i++)
+  {
+    const uint32_t levels[2] = { (data[i] >> 15) & 0x01, (data[i] >> 31) & 0x01 };
+    const uint32_t durations[2] = { data[i] & 0x7fff, (data[i] >> 16) & 0x7fff };
+    for(size_t h = 0; h < 2; h++)
+    {
+      if(!durations[h]) return bitCount < 21 ? EscDriver::pushBits(value, 0x1, 21 - bitCount) : value;
+      const uint32_t n = EscDriver::durationToBitLen(durations[h], bitLen);
+      value = EscDriver::pushBits(value, levels[h], n);
+      bitCount += n;
+    }
+  }
+  return bitCount < 21 ? EscDriver::pushBits(value, 0x1, 21 - bitCount) : value;
+}
+
+static uint32_t referenceGcrToRawValue(uint32_t value)
+{
+  value = (value ^ (value >> 1)) & 0xfffff;
+  const uint32_t iv = 0xffffffff;
+  static const uint32_t decode[32] = {
+    iv, iv, iv, iv, iv, iv, iv, iv, iv, 9, 10, 11, iv, 13, 14, 15,
+    iv, iv,  2,  3, iv,  5,  6,  7, iv, 0,  8,  1, iv,  4, 12, iv,
+  };
+  uint32_t decoded = decode[value & 0x1f];
+  decoded |= decode[(value >>  5) & 0x1f] <<  4;
+  decoded |= decode[(value >> 10) & 0x1f] <<  8;
+  decoded |= decode[(value >> 15) & 0x1f] << 12;
+  uint32_t csum = decoded;
+  csum = csum ^ (csum >> 8);
+  csum = csum ^ (csum >> 4);
+  if((csum & 0xf) != 0xf || decoded > 0xffff) return EscDriver::INVALID_TELEMETRY_VALUE;
+  return decoded >> 4;
+}
+
+// captured bluejay dshot300 frames from docs/dshot_gcr_dump.txt, level:duration runs
+static const char * const gcrDump[] = {
+  "0:375 1:168 0:10368 0:14 0:381 1:162 0:172 1:172 0:384 1:159 0:178 1:168 0:166 1:168 0:603",
+  "0:381 1:165 0:172 1:172 0:377 1:176 0:165 1:171 0:381 1:169 0:168 1:172 0:175 1:172 0:593",
+  "0:381 1:172 0:171 1:165 0:385 1:168 0:168 1:169 0:381 1:169 0:178 1:162 0:175 1:171 0:607",
+  "0:380 1:172 0:175 1:172 0:371 1:172 0:175 1:172 0:371 1:172 0:174 1:162 0:172 1:172 0:606",
+  "0:380 1:170 0:170 1:173 0:376 1:173 0:171 1:170 0:389 1:170 0:173 1:177 0:160 1:174 0:598",
+  "0:380 1:173 0:173 1:174 0:369 1:174 0:173 1:173 0:370 1:173 0:174 1:163 0:170 1:173 0:606",
+  "0:380 1:163 0:170 1:174 0:382 1:160 0:177 1:170 0:373 1:170 0:174 1:176 0:160 1:174 0:598",
+  "0:379 1:167 0:170 1:174 0:376 1:176 0:164 1:173 0:380 1:170 0:167 1:173 0:173 1:174 0:592",
+  "0:380 1:173 0:177 1:170 0:382 1:174 0:173 1:163 0:380 1:173 0:174 1:160 0:177 1:170 0:608",
+  "0:373 1:605 0:163 1:605 0:174 1:376 0:379 1:599 0:177 1:163 0:173",
+  "0:379 1:599 0:170 1:654 0:170 1:170 0:184 1:605 0:173 1:379 0:380",
+  "0:383 1:605 0:163 1:602 0:177 1:163 0:383 1:170 0:170 1:167 0:605",
+  "0:370 1:601 0:174 1:605 0:595 1:173 0:174 1:163 0:380 1:379 0:174",
+  "0:379 1:595 0:174 1:605 0:164 1:173 0:173 1:379 0:164 1:173 0:174 1:163 0:380",
+  "0:383 1:605 0:167 1:608 0:161 1:379 0:608 1:164 0:173 1:170 0:167",
+  "0:177 1:379 0:177 1:167 0:173 1:164 0:379 1:177 0:373 1:379 0:380 1:608 0:164",
+  "0:173 1:379 0:167 1:173 0:167 1:605 0:386 1:164 0:379 1:376 0:602",
+  "0:183 1:380 0:173 1:173 0:164 1:605 0:380 1:604 0:164 1:379 0:664",
+  "0:174 1:379 0:173 1:164 0:226 1:601 0:383 1:599 0:376 1:180 0:373",
+  "0:173 1:380 0:163 1:173 0:174 1:602 0:595 1:173 0:380 1:173 0:380 1:163 0:173",
+  "0:167 1:379 0:170 1:173 0:164 1:602 0:602 1:173 0:173 1:380 0:163 1:173 0:380",
+  "0:164 1:379 0:174 1:173 0:164 1:605 0:605 1:163 0:174 1:379 0:174 1:163 0:380",
+  "0:380 1:595 0:173 1:605 0:164 1:173 0:174 1:379 0:164 1:173 0:174 1:163 0:380",
+  "0:379 1:602 0:173 1:599 0:170 1:386 0:386 1:608 0:164 1:173 0:174",
+  "0:380 1:595 0:10368 0:14 0:599 1:173 0:1",
+  "0:373 1:602 0:180 1:598 0:380 1:166 0:171 1:166 0:383 1:173 0:377",
+  "0:380 1:605 0:173 1:596 0:605 1:173 0:379 1:380 0:595",
+  "0:383 1:173 0:164 1:170 0:382 1:174 0:173 1:164 0:379 1:173 0:174 1:160 0:177 1:170 0:608",
+  "0:382 1:170 0:167 1:170 0:380 1:170 0:177 1:163 0:380 1:173 0:170 1:167 0:173 1:174 0:595",
+  "0:383 1:170 0:164 1:170 0:383 1:176 0:161 1:173 0:379 1:174 0:177 1:170 0:173 1:177 0:592",
+  "0:379 1:173 0:174 1:173 0:370 1:173 0:174 1:173 0:369 1:174 0:173 1:164 0:170 1:173 0:605",
+  "0:382 1:170 0:164 1:170 0:383 1:176 0:161 1:173 0:380 1:173 0:177 1:170 0:173 1:177 0:592",
+  "0:383 1:170 0:167 1:170 0:380 1:170 0:177 1:163 0:380 1:173 0:170 1:167 0:173 1:173 0:596",
+  "0:384 1:175 0:162 1:172 0:381 1:172 0:178 1:169 0:384 1:172 0:175 1:162 0:171 1:172 0:597",
+  "0:387 1:162 0:172 1:169 0:390 1:159 0:175 1:169 0:384 1:175 0:172 1:171 0:179 1:158 0:604",
+  "0:381 1:168 0:172 1:172 0:378 1:171 0:172 1:169 0:390 1:169 0:175 1:175 0:162 1:172 0:600",
+};
+
+static size_t parseGcrDump(const char * line, uint32_t * data, size_t max)
+{
+  size_t count = 0;
+  uint32_t level, duration;
+  int used = 0;
+  while(count < max * 2 && sscanf(line, "%u:%u%n", &level, &duration, &used) == 2)
+  {
+    line += used;
+    const uint32_t half = (duration & 0x7fff) | (level & 0x1) << 15;
+    if(count & 1) data[count >> 1] |= half << 16;
+    else data[count >> 1] = half;
+    count++;
+  }
+  if(count & 1) count++; // second half stays zero
+  return count >> 1;
+}
+
+void test_esc_extract_telemetry_gcr_dump()
+{
+  const uint32_t bit_len = 213;
+  size_t valid = 0;
+  for(size_t i = 0; i < sizeof(gcrDump) / sizeof(gcrDump[0]); i++)
+  {
+    uint32_t data[16] = {};
+    const size_t len = parseGcrDump(gcrDump[i], data, 16);
+    TEST_ASSERT_GREATER_THAN(0, len);
+    const uint32_t gcr = EscDriver::extractTelemetryGcr(data, len, bit_len);
+    TEST_ASSERT_EQUAL_HEX32(referenceExtractGcr(data, len, bit_len), gcr);
+    const uint32_t value = EscDriver::gcrToRawValue(gcr);
+    TEST_ASSERT_EQUAL_HEX32(referenceGcrToRawValue(gcr), value);
+    if(value != EscDriver::INVALID_TELEMETRY_VALUE) valid++;
+  }
+  TEST_ASSERT_GREATER_THAN(30, valid);
+}
+
+void test_esc_extract_telemetry_gcr_random()
+{
+  uint32_t seed = 12345;
+  auto rnd = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+  for(size_t n = 0; n < 20000; n++)
+  {
+    const uint32_t bit_len = 50 + rnd() % 400;
+    uint32_t data[12];
+    const size_t len = 1 + rnd() % 12;
+    for(size_t i = 0; i < len; i++)
+    {
+      // mostly short runs, some long and zero terminators
+      const uint32_t d0 = rnd() % 8 ? rnd() % (bit_len * 4) : rnd() & 0x7fff;
+      const uint32_t d1 = rnd() % 16 ? rnd() % (bit_len * 4) : 0;
+      data[i] = make_item(d0, rnd() & 1, d1, rnd() & 1);
+    }
+    TEST_ASSERT_EQUAL_HEX32(referenceExtractGcr(data, len, bit_len), EscDriver::extractTelemetryGcr(data, len, bit_len));
+  }
+}
+
+void test_esc_gcr_to_raw_value_all()
+{
+  for(uint32_t gcr = 0; gcr < (1u << 21); gcr++)
+  {
+    if(EscDriver::gcrToRawValue(gcr) != referenceGcrToRawValue(gcr))
+    {
+      TEST_ASSERT_EQUAL_HEX32(referenceGcrToRawValue(gcr), EscDriver::gcrToRawValue(gcr));
+    }
+  }
+}
+
 int main(int argc, char **argv)
 {
   UNITY_BEGIN();
   RUN_TEST(test_esc_dshot_encode);
   RUN_TEST(test_esc_dshot_encode_inverted);
   RUN_TEST(test_esc_dshot_convert);
+  RUN_TEST(test_esc_dshot_frame_matches_encode);
   RUN_TEST(test_esc_gcr_to_raw_value);
   RUN_TEST(test_esc_gcr_convert_to_value);
   RUN_TEST(test_esc_gcr_convert_to_erpm);
@@ -263,6 +419,9 @@ int main(int argc, char **argv)
   RUN_TEST(test_esc_extract_telemetry_dshot300_sample);
   RUN_TEST(test_esc_extract_telemetry_dshot300_running);
   RUN_TEST(test_esc_extract_telemetry_dshot300_idle);
+  RUN_TEST(test_esc_extract_telemetry_gcr_dump);
+  RUN_TEST(test_esc_extract_telemetry_gcr_random);
+  RUN_TEST(test_esc_gcr_to_raw_value_all);
   UNITY_END();
 
   return 0;
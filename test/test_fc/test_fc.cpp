@@ -2,10 +2,12 @@
 #include <ArduinoFake.h>
 #include <EscDriver.h>
 #include "Timer.h"
+#include "Scheduler.h"
 #include "Model.h"
 #include "Controller.h"
 #include "Actuator.h"
 #include "Output/Mixer.h"
+#include "Utils/FilterLatency.h"
 
 using namespace fakeit;
 using namespace Espfc;
@@ -102,6 +104,175 @@ void test_timer_check_micros()
   Verify(Method(ArduinoFake(), micros)).Exactly(6_Times);
 }
 
+// virtual clock, tasks advance it by their cost
+static uint32_t schedulerTime = 0;
+static uint32_t schedulerCycle = 0;
+
+static uint32_t schedulerClock()
+{
+  return schedulerTime;
+}
+
+struct SchedulerProbe
+{
+  uint32_t cost;
+  uint32_t runs;
+  uint32_t cycle;
+};
+
+static void schedulerTask(void * ctx)
+{
+  SchedulerProbe * p = static_cast<SchedulerProbe*>(ctx);
+  schedulerTime += p->cost;
+  p->runs++;
+  p->cycle = schedulerCycle;
+}
+
+static void schedulerRun(Scheduler& s, uint32_t cycles, uint32_t period)
+{
+  for(uint32_t i = 0; i < cycles; i++)
+  {
+    schedulerCycle = i;
+    schedulerTime = i * period;
+    s.run(i);
+  }
+}
+
+void test_scheduler_plan_spreads_load()
+{
+  Scheduler s;
+  SchedulerProbe p[5] = {};
+  s.add("gyro",   schedulerTask, &p[0], 1, 0, 40, 0);
+  s.add("pid",    schedulerTask, &p[1], 2, 0, 30, 0);
+  s.add("baro",   schedulerTask, &p[2], 4, 2, 20);
+  s.add("accel",  schedulerTask, &p[3], 4, 1, 20);
+  s.add("serial", schedulerTask, &p[4], 8, 3, 10);
+  s.begin(125);
+
+  TEST_ASSERT_EQUAL_UINT32(8, s.cycles());
+  TEST_ASSERT_EQUAL_UINT32(0, s.task(1).slot);
+  // pid takes even cycles, higher priority accel picks first free odd slot
+  TEST_ASSERT_EQUAL_UINT32(1, s.task(3).slot);
+  TEST_ASSERT_EQUAL_UINT32(3, s.task(2).slot);
+  TEST_ASSERT_EQUAL_UINT32(1, s.task(4).slot);
+
+  for(uint32_t c = 0; c < s.cycles(); c++)
+  {
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(70, s.plannedLoad(c));
+  }
+}
+
+void test_scheduler_run_rates()
+{
+  Scheduler s;
+  SchedulerProbe p[4] = {};
+  s.setClock(schedulerClock);
+  s.add("gyro",  schedulerTask, &p[0], 1, 0, 20, 0);
+  s.add("pid",   schedulerTask, &p[1], 2, 0, 20, 0);
+  s.add("input", schedulerTask, &p[2], 1, 1, 10, 1); // slot limited to rate
+  s.add("mag",   schedulerTask, &p[3], 0, 2, 10);    // disabled
+  s.begin(1000);
+
+  TEST_ASSERT_EQUAL_UINT32(0, s.task(2).slot);
+
+  schedulerRun(s, 64, 1000);
+
+  TEST_ASSERT_EQUAL_UINT32(64, p[0].runs);
+  TEST_ASSERT_EQUAL_UINT32(32, p[1].runs);
+  TEST_ASSERT_EQUAL_UINT32(64, p[2].runs);
+  TEST_ASSERT_EQUAL_UINT32(0, p[3].runs);
+  TEST_ASSERT_EQUAL_UINT32(32, s.task(1).runs);
+  TEST_ASSERT_EQUAL_UINT32(0, s.task(2).deferrals);
+  TEST_ASSERT_EQUAL_UINT32(0, s.task(2).misses);
+}
+
+void test_scheduler_defers_low_priority()
+{
+  Scheduler s;
+  SchedulerProbe gyro = { 90, 0, 0 }, serial = { 10, 0, 0 };
+  s.setClock(schedulerClock);
+  s.add("gyro",   schedulerTask, &gyro,   1, 0, 80, 0);
+  s.add("serial", schedulerTask, &serial, 1, 3, 30);
+  s.begin(100);
+
+  // no room after gyro, serial waits one cycle, then it is forced
+  schedulerRun(s, 4, 100);
+
+  TEST_ASSERT_EQUAL_UINT32(4, gyro.runs);
+  TEST_ASSERT_EQUAL_UINT32(4, s.task(0).overruns);
+  TEST_ASSERT_EQUAL_UINT32(90, s.task(0).maxTime);
+  TEST_ASSERT_EQUAL_UINT32(0, s.task(0).deferrals);
+
+  TEST_ASSERT_EQUAL_UINT32(2, serial.runs);
+  TEST_ASSERT_EQUAL_UINT32(3, serial.cycle);
+  TEST_ASSERT_EQUAL_UINT32(2, s.task(1).deferrals);
+  TEST_ASSERT_EQUAL_UINT32(2, s.task(1).misses);
+  TEST_ASSERT_EQUAL_UINT32(0, s.task(1).overruns);
+
+  s.resetStats();
+  TEST_ASSERT_EQUAL_UINT32(0, s.task(0).overruns);
+  TEST_ASSERT_EQUAL_UINT32(0, s.task(1).deferrals);
+}
+
+void test_scheduler_follow()
+{
+  Scheduler s;
+  SchedulerProbe p[3] = {};
+  s.setClock(schedulerClock);
+  s.add("pid", schedulerTask, &p[0], 1, 0, 50, 0);
+  const int accel = s.add("accel", schedulerTask, &p[1], 4, 1, 20);
+  s.follow(accel, "imu", schedulerTask, &p[2], 1, 20);
+  s.begin(1000);
+
+  TEST_ASSERT_EQUAL_UINT32(4, s.task(2).denom);
+  TEST_ASSERT_EQUAL_UINT32((s.task(1).slot + 1) % 4, s.task(2).slot);
+
+  for(uint32_t i = 0; i < 16; i++)
+  {
+    schedulerCycle = i;
+    s.run(i);
+    if(p[1].runs && p[1].cycle == i) TEST_ASSERT_EQUAL_UINT32(p[1].runs - 1, p[2].runs);
+  }
+  TEST_ASSERT_EQUAL_UINT32(4, p[1].runs);
+  TEST_ASSERT_EQUAL_UINT32(p[1].cycle + 1, p[2].cycle);
+}
+
+void test_stats_cycles_to_micros()
+{
+  Stats stats;
+  stats.begin(240000000); // esp32 cpu clock
+
+  // 2.5us pid with rare 100us spikes
+  for(uint32_t i = 0; i < 1000; i++) stats.add(COUNTER_INNER_PID, i % 100 ? 600 : 24000);
+  stats.addMicros(COUNTER_WAKEUP, 50);
+
+  TEST_ASSERT_EQUAL_UINT32(1000, stats.getSamples(COUNTER_INNER_PID));
+  TEST_ASSERT_FLOAT_WITHIN(0.2f, 2.5f, stats.getMin(COUNTER_INNER_PID));
+  TEST_ASSERT_FLOAT_WITHIN(0.2f, 2.5f, stats.getPercentile(COUNTER_INNER_PID, 0.5f));
+  TEST_ASSERT_FLOAT_WITHIN(0.2f, 2.5f, stats.getPercentile(COUNTER_INNER_PID, 0.98f));
+  TEST_ASSERT_FLOAT_WITHIN(1.f, 100.f, stats.getPercentile(COUNTER_INNER_PID, 0.999f));
+  TEST_ASSERT_FLOAT_WITHIN(1.f, 100.f, stats.getMax(COUNTER_INNER_PID));
+  TEST_ASSERT_FLOAT_WITHIN(1.f, 50.f, stats.getMax(COUNTER_WAKEUP));
+
+  stats.reset();
+  TEST_ASSERT_EQUAL_UINT32(0, stats.getSamples(COUNTER_INNER_PID));
+}
+
+void test_stats_measure_timebase()
+{
+  Stats stats;
+  stats.begin(targetCycleFreq());
+  volatile float acc = 0.f;
+  {
+    Stats::Measure measure(stats, COUNTER_GYRO_FILTER);
+    for(int i = 0; i < 1000; i++) acc = acc + i * 0.5f;
+  }
+
+  TEST_ASSERT_EQUAL_UINT32(1, stats.getSamples(COUNTER_GYRO_FILTER));
+  TEST_ASSERT_TRUE(stats.getMax(COUNTER_GYRO_FILTER) > 0.f);
+  TEST_ASSERT_TRUE(stats.getMax(COUNTER_GYRO_FILTER) < 100000.f);
+}
+
 void test_model_gyro_init_1k_256dlpf()
 {
   Model model;
@@ -192,6 +363,43 @@ void test_model_outer_pid_init()
   TEST_ASSERT_FLOAT_WITHIN(0.0001f,    0.1f, model.state.outerPid[FC_PID_PITCH].Kf);
 }
 
+void test_model_filter_latency()
+{
+  Model model;
+  model.state.gyroClock = 1000;
+  model.config.gyroDlpf = GYRO_DLPF_256;
+  model.config.loopSync = 1;
+  model.config.mixerSync = 1;
+  model.config.gyroFilter3 = FilterConfig(FILTER_FO, 150);
+  model.config.output.dshotTelemetry = false;
+  model.begin();
+
+  Utils::FilterLatency latency(model);
+  latency.compute(50);
+
+  TEST_ASSERT_FLOAT_WITHIN(1e-7f, model.state.gyroFilter3.getGroupDelay(50), latency.delay[Utils::FilterLatency::GYRO_LPF3]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-7f, model.state.gyroFilter.getGroupDelay(50), latency.delay[Utils::FilterLatency::GYRO_LPF1]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-7f, model.state.innerPid[0].dtermFilter.getGroupDelay(50), latency.delay[Utils::FilterLatency::DTERM_LPF1]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-7f, 0.0005f, latency.delay[Utils::FilterLatency::DTERM_DIFF]);
+  TEST_ASSERT_EQUAL_FLOAT(0.f, latency.delay[Utils::FilterLatency::GYRO_SMA]);
+  TEST_ASSERT_EQUAL_FLOAT(0.f, latency.delay[Utils::FilterLatency::GYRO_RPM]);
+  TEST_ASSERT_TRUE(latency.delay[Utils::FilterLatency::GYRO_LPF1] > 0.f);
+
+  float gyro = 0.f;
+  for(size_t i = Utils::FilterLatency::GYRO_SMA; i < Utils::FilterLatency::DTERM_DIFF; i++) gyro += latency.delay[i];
+  TEST_ASSERT_FLOAT_WITHIN(1e-7f, gyro, latency.gyro());
+  TEST_ASSERT_TRUE(latency.dterm() > latency.gyro());
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, latency.gyro() * 50 * 360, Utils::FilterLatency::phase(latency.gyro(), 50));
+
+  // sample averaging instead of lpf3
+  model.config.gyroFilter3 = FilterConfig(FILTER_FO, 0);
+  model.config.loopSync = 2;
+  model.begin();
+  latency.compute(50);
+  TEST_ASSERT_FLOAT_WITHIN(1e-7f, 0.5f / model.state.gyroRate, latency.delay[Utils::FilterLatency::GYRO_SMA]);
+  TEST_ASSERT_EQUAL_FLOAT(0.f, latency.delay[Utils::FilterLatency::GYRO_LPF3]);
+}
+
 void test_controller_rates()
 {
   Model model;
@@ -287,6 +495,31 @@ void test_controller_rates_limit()
   TEST_ASSERT_FLOAT_WITHIN(0.01f,  -6.98f, controller.calculateSetpointRate(AXIS_YAW, 1.0f));
 }
 
+void test_controller_input_snapshot()
+{
+  Model model;
+  model.state.gyroClock = 8000;
+  model.config.gyroDlpf = GYRO_DLPF_256;
+  model.config.loopSync = 8;
+  model.config.mixerSync = 1;
+  model.config.mixerType = FC_MIXER_QUADX;
+  model.begin();
+
+  Controller controller(model);
+  controller.begin();
+
+  // live input may be updated by input task, controller uses snapshot only
+  model.state.input[AXIS_ROLL] = 1.0f;
+  model.state.input[AXIS_THRUST] = 0.9f;
+  model.state.inputSampled.input[AXIS_ROLL] = 0.5f;
+  model.state.inputSampled.input[AXIS_THRUST] = -0.2f;
+
+  controller.outerLoop();
+
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, controller.calculateSetpointRate(AXIS_ROLL, 0.5f), model.state.desiredRate[AXIS_ROLL]);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, -0.2f, model.state.desiredRate[AXIS_THRUST]);
+}
+
 void test_rates_betaflight()
 {
   InputConfig config;
@@ -446,6 +679,35 @@ void test_rates_kiss_expo()
   TEST_ASSERT_FLOAT_WITHIN(0.01f, -13.45f, rates.getSetpoint(AXIS_ROLL, -1.0f));
 }
 
+void test_rates_table_matches_exact()
+{
+  InputConfig config;
+  config.rate[AXIS_ROLL]  =  70; config.expo[AXIS_ROLL]  =  0; config.superRate[AXIS_ROLL]  = 80;
+  config.rate[AXIS_PITCH] = 120; config.expo[AXIS_PITCH] = 30; config.superRate[AXIS_PITCH] = 70;
+  config.rate[AXIS_YAW]   =  20; config.expo[AXIS_YAW]   = 50; config.superRate[AXIS_YAW]   = 40;
+  for(size_t i = 0; i < 3; i++) config.rateLimit[i] = 1998;
+
+  for(int type = RATES_TYPE_BETAFLIGHT; type <= RATES_TYPE_QUICK; type++)
+  {
+    config.rateType = type;
+    Rates rates;
+    rates.begin(config);
+    float maxError = 0.f;
+    for(int axis = AXIS_ROLL; axis <= AXIS_YAW; axis++)
+    {
+      for(int i = -1000; i <= 1000; i++)
+      {
+        const float input = i * 0.001f;
+        maxError = std::max(maxError, std::abs(rates.getSetpoint(axis, input) - rates.getSetpointExact(axis, input)));
+      }
+      TEST_ASSERT_EQUAL_FLOAT(rates.getSetpointExact(axis, 1.0f), rates.getSetpoint(axis, 1.0f));
+      TEST_ASSERT_EQUAL_FLOAT(0.f, rates.getSetpoint(axis, 0.0f));
+    }
+    // steepest near full stick, 128 entries keep it below 2 deg/s
+    TEST_ASSERT_TRUE(Math::toDeg(maxError) < 2.f);
+  }
+}
+
 void test_actuator_arming_gyro_motor_calbration()
 {
   Model model;
@@ -620,6 +882,260 @@ void test_mixer_output_limit_servo()
   TEST_ASSERT_FLOAT_WITHIN(0.001f,  0.8f, mixer.limitOutput( 1.0f, servo, 80));
 }
 
+void test_mixer_matrix_quadx()
+{
+  MixerConfig custom;
+  Output::MixerMatrix matrix;
+  matrix.compile(Output::Mixers::getMixer(FC_MIXER_QUADX, custom));
+  TEST_ASSERT_EQUAL_UINT32(4, matrix.count());
+
+  const float rpy[] = { 0.1f, 0.2f, 0.05f };
+  const float pass[Output::MixerMatrix::PASS] = { 0.3f, 0.9f, 0.9f, 0.9f, 0.9f, 0.9f, 0.9f, 0.9f };
+  float out[OUTPUT_CHANNELS];
+  matrix.mixStabilized(rpy, out);
+
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f,  0.05f, out[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, -0.25f, out[1]);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f,  0.35f, out[2]);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, -0.15f, out[3]);
+
+  // only thrust is used
+  matrix.mixPassThrough(pass, out);
+
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f,  0.35f, out[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f,  0.05f, out[1]);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f,  0.65f, out[2]);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f,  0.15f, out[3]);
+}
+
+void test_mixer_matrix_custom_rules()
+{
+  MixerEntry mixes[] = {
+    MixerEntry(MIXER_SOURCE_ROLL,     0,  100),
+    MixerEntry(MIXER_SOURCE_ROLL,     0,   50), // same cell is summed
+    MixerEntry(MIXER_SOURCE_PITCH,    1,    0), // zero rate
+    MixerEntry(MIXER_SOURCE_YAW,      2,  100), // out of count
+    MixerEntry(MIXER_SOURCE_YAW,     -1,  100), // invalid dst
+    MixerEntry(-3,                    1,  100), // invalid src
+    MixerEntry(MIXER_SOURCE_RC_AUX1,  1,  -50),
+    MixerEntry(MIXER_SOURCE_THRUST,   1,  100),
+    MixerEntry(),
+    MixerEntry(MIXER_SOURCE_PITCH,    0,  100), // after terminator
+  };
+  Output::MixerMatrix matrix;
+  matrix.compile(MixerConfig(2, mixes));
+  TEST_ASSERT_EQUAL_UINT32(2, matrix.count());
+
+  const float rpy[] = { 0.2f, 0.4f, 0.8f };
+  float pass[Output::MixerMatrix::PASS] = {};
+  pass[0] = 0.5f;
+  pass[MIXER_SOURCE_RC_AUX1 - MIXER_SOURCE_THRUST] = 0.6f;
+  float out[OUTPUT_CHANNELS] = { 1.f, 1.f, 1.f, 1.f };
+  matrix.mixStabilized(rpy, out);
+  matrix.mixPassThrough(pass, out);
+
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.3f, out[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.2f, out[1]);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.0f, out[2]);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.0f, out[3]);
+}
+
+// rules evaluated one by one in float, as reference for compiled matrix
+static void assert_mixer_matrix_error(const MixerConfig& mixer, float maxError)
+{
+  Output::MixerMatrix matrix;
+  matrix.compile(mixer);
+
+  float err = 0.f;
+  for(size_t n = 0; n < 200; n++)
+  {
+    float sources[MIXER_SOURCE_MAX] = {};
+    for(size_t j = MIXER_SOURCE_ROLL; j < MIXER_SOURCE_MAX; j++)
+    {
+      sources[j] = 0.9f * sinf(n * 0.07f + j * 1.3f);
+    }
+    float expected[OUTPUT_CHANNELS] = {};
+    for(size_t k = 0; k < MIXER_RULE_MAX && mixer.mixes[k].src != MIXER_SOURCE_NULL; k++)
+    {
+      const MixerEntry& e = mixer.mixes[k];
+      if(e.dst < 0 || (size_t)e.dst >= matrix.count()) continue;
+      expected[e.dst] += e.rate * 0.01f * sources[e.src];
+    }
+    float out[OUTPUT_CHANNELS] = {};
+    matrix.mixStabilized(sources + MIXER_SOURCE_ROLL, out);
+    matrix.mixPassThrough(sources + MIXER_SOURCE_THRUST, out);
+    for(size_t i = 0; i < matrix.count(); i++)
+    {
+      err = std::max(err, std::abs(expected[i] - out[i]));
+    }
+  }
+  TEST_ASSERT_FLOAT_WITHIN(maxError, 0.f, err);
+}
+
+void test_mixer_matrix_error_bound()
+{
+  MixerConfig custom;
+  assert_mixer_matrix_error(Output::Mixers::getMixer(FC_MIXER_QUADX, custom), 0.00005f);
+  assert_mixer_matrix_error(Output::Mixers::getMixer(FC_MIXER_QUADX_1234, custom), 0.00005f);
+  assert_mixer_matrix_error(Output::Mixers::getMixer(FC_MIXER_TRI, custom), 0.00005f);
+  assert_mixer_matrix_error(Output::Mixers::getMixer(FC_MIXER_GIMBAL, custom), 0.00005f);
+
+  // fractional and summed rates, rc and aux sources
+  MixerEntry mixes[] = {
+    MixerEntry(MIXER_SOURCE_ROLL,     0,   33),
+    MixerEntry(MIXER_SOURCE_PITCH,    0,  -67),
+    MixerEntry(MIXER_SOURCE_YAW,      1,  127),
+    MixerEntry(MIXER_SOURCE_YAW,      1,  127),
+    MixerEntry(MIXER_SOURCE_THRUST,   1,    1),
+    MixerEntry(MIXER_SOURCE_RC_ROLL,  2,  -99),
+    MixerEntry(MIXER_SOURCE_RC_AUX1,  2,   45),
+    MixerEntry(MIXER_SOURCE_RC_AUX3,  3, -128),
+    MixerEntry(),
+  };
+  assert_mixer_matrix_error(MixerConfig(4, mixes), 0.00005f);
+}
+
+void test_mixer_update_custom()
+{
+  Model model;
+  model.config.customMixes[0] = MixerEntry(MIXER_SOURCE_THRUST,     0, 100);
+  model.config.customMixes[1] = MixerEntry(MIXER_SOURCE_ROLL,       1, 100);
+  model.config.customMixes[2] = MixerEntry(MIXER_SOURCE_RC_ROLL,    1,  50);
+  model.config.customMixes[3] = MixerEntry(MIXER_SOURCE_YAW,        2, 100);
+  model.config.customMixes[4] = MixerEntry(MIXER_SOURCE_RC_AUX2,    3, 100);
+  model.config.customMixes[5] = MixerEntry();
+  model.config.output.channel[1].servo = true;
+  model.config.output.channel[2].servo = true;
+  model.config.output.channel[3].servo = true;
+  model.state.currentMixer = MixerConfig(4, model.config.customMixes);
+  model.state.output[AXIS_ROLL] = 0.2f;
+  model.state.output[AXIS_YAW] = 0.1f;
+  model.state.output[AXIS_THRUST] = -0.5f;
+  model.state.inputSampled.input[AXIS_ROLL] = 0.4f;
+  model.state.inputSampled.input[AXIS_AUX_2] = -0.7f;
+
+  Output::Mixer mixer(model);
+  Output::MixerMatrix matrix;
+  matrix.compile(model.state.currentMixer);
+  float out[OUTPUT_CHANNELS];
+  mixer.updateMixer(matrix, out);
+
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, -0.5f, out[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f,  0.4f, out[1]);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, -0.1f, out[2]); // yaw reversed
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, -0.7f, out[3]);
+}
+
+void test_output_curve_inactive()
+{
+  ModelConfig config;
+  Output::OutputCurve curve;
+  curve.begin(config.output, 3.7f);
+  TEST_ASSERT_FALSE(curve.active());
+  TEST_ASSERT_FALSE(curve.update(3.3f));
+
+  float out[OUTPUT_CHANNELS] = { -1.f, -0.3f, 0.4f, 1.f };
+  curve.apply(out, 4);
+  TEST_ASSERT_EQUAL_FLOAT(-1.f, out[0]);
+  TEST_ASSERT_EQUAL_FLOAT(-0.3f, out[1]);
+  TEST_ASSERT_EQUAL_FLOAT(0.4f, out[2]);
+  TEST_ASSERT_EQUAL_FLOAT(1.f, out[3]);
+}
+
+void test_output_curve_thrust_linear()
+{
+  ModelConfig config;
+  config.output.thrustLinear = 40;
+  config.output.channel[3].servo = true;
+  Output::OutputCurve curve;
+  curve.begin(config.output, 0.f);
+  TEST_ASSERT_TRUE(curve.active());
+
+  // idle and full output are kept, low output is boosted
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, -1.f, curve.getExact(0, -1.f));
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f,  1.f, curve.getExact(0,  1.f));
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, -0.3875f, curve.getExact(0, -0.5f)); // 0.25 * (1 + 0.4 * 0.5625) = 0.30625
+
+  for(int k = -100; k <= 100; k++)
+  {
+    const float v = k * 0.01f;
+    float out[OUTPUT_CHANNELS] = { v, v, v, v };
+    curve.apply(out, 4);
+    TEST_ASSERT_FLOAT_WITHIN(0.002f, curve.getExact(0, v), out[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.002f, curve.getExact(1, v), out[1]);
+    TEST_ASSERT_EQUAL_FLOAT(v, out[3]); // servo
+  }
+}
+
+void test_output_curve_sag_compensation()
+{
+  ModelConfig config;
+  config.output.vbatSagCompensation = 100;
+  config.output.motorScale[1] = 80;
+  Output::OutputCurve curve;
+  curve.begin(config.output, 4.2f);
+
+  float out[OUTPUT_CHANNELS] = { 0.f, 0.f, 0.f, 0.f };
+  curve.apply(out, 4);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f,  0.0f, out[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, -0.2f, out[1]);
+
+  // small voltage change keeps tables
+  TEST_ASSERT_FALSE(curve.update(4.18f));
+
+  // voltage is smoothed, tables follow in steps
+  int rebuilds = 0;
+  for(int i = 0; i < 1000; i++) rebuilds += curve.update(3.5f);
+  TEST_ASSERT_TRUE(rebuilds > 1);
+  TEST_ASSERT_TRUE(rebuilds <= 14);
+
+  out[0] = 0.f; out[1] = 0.f;
+  curve.apply(out, 4);
+  TEST_ASSERT_FLOAT_WITHIN(0.02f, 0.2f, out[0]);  // 0.5 * 4.2 / 3.5 = 0.6
+  TEST_ASSERT_FLOAT_WITHIN(0.02f, -0.04f, out[1]); // 0.6 * 0.8 = 0.48
+}
+
+void test_output_curve_sag_under_throttle()
+{
+  ModelConfig config;
+  config.output.vbatSagCompensation = 100;
+  Output::OutputCurve curve;
+  curve.begin(config.output, 3.8f);
+
+  // voltage drops and recovers with throttle punches, tables are kept
+  int rebuilds = 0;
+  for(int i = 0; i < 1000; i++) rebuilds += curve.update(i % 20 < 10 ? 3.72f : 3.82f);
+  TEST_ASSERT_EQUAL_INT(0, rebuilds);
+}
+
+void test_mixer_output_curve_limit()
+{
+  Model model;
+  model.config.mixerType = FC_MIXER_QUADX;
+  model.config.output.thrustLinear = 40;
+  model.config.output.vbatSagCompensation = 100;
+  model.config.output.motorLimit = 80;
+  model.state.battery.cellVoltage = 3.3f;
+  Output::Mixer mixer(model);
+  mixer.begin();
+
+  Output::MixerMatrix matrix;
+  matrix.compile(model.state.currentMixer);
+
+  // boosted outputs stay within motor limit and are seen as saturated
+  float out[OUTPUT_CHANNELS];
+  bool saturated = false;
+  for(int k = -100; k <= 100; k++)
+  {
+    model.state.output[AXIS_THRUST] = k * 0.01f;
+    model.state.output[AXIS_ROLL] = 0.1f;
+    mixer.updateMixer(matrix, out);
+    for(size_t i = 0; i < 4; i++) TEST_ASSERT_TRUE(out[i] <= 0.6f + 0.0001f);
+    if(k == 80) saturated = model.state.outputSaturated;
+  }
+  TEST_ASSERT_TRUE(saturated);
+}
+
 int main(int argc, char **argv)
 {
   UNITY_BEGIN();
@@ -628,18 +1144,27 @@ int main(int argc, char **argv)
   RUN_TEST(test_timer_interval_10ms);
   RUN_TEST(test_timer_check);
   RUN_TEST(test_timer_check_micros);
+  RUN_TEST(test_scheduler_plan_spreads_load);
+  RUN_TEST(test_scheduler_run_rates);
+  RUN_TEST(test_scheduler_defers_low_priority);
+  RUN_TEST(test_scheduler_follow);
+  RUN_TEST(test_stats_cycles_to_micros);
+  RUN_TEST(test_stats_measure_timebase);
   RUN_TEST(test_model_gyro_init_1k_256dlpf);
   RUN_TEST(test_model_gyro_init_1k_188dlpf);
   RUN_TEST(test_model_inner_pid_init);
   RUN_TEST(test_model_outer_pid_init);
+  RUN_TEST(test_model_filter_latency);
   RUN_TEST(test_controller_rates);
   RUN_TEST(test_controller_rates_limit);
+  RUN_TEST(test_controller_input_snapshot);
   RUN_TEST(test_rates_betaflight);
   RUN_TEST(test_rates_betaflight_expo);
   RUN_TEST(test_rates_raceflight);
   RUN_TEST(test_rates_raceflight_expo);
   RUN_TEST(test_rates_kiss);
   RUN_TEST(test_rates_kiss_expo);
+  RUN_TEST(test_rates_table_matches_exact);
   RUN_TEST(test_actuator_arming_gyro_motor_calbration);
   RUN_TEST(test_actuator_arming_failsafe);
   RUN_TEST(test_actuator_arming_throttle);
@@ -648,6 +1173,15 @@ int main(int argc, char **argv)
   RUN_TEST(test_mixer_throttle_limit_clip);
   RUN_TEST(test_mixer_output_limit_motor);
   RUN_TEST(test_mixer_output_limit_servo);
+  RUN_TEST(test_mixer_matrix_quadx);
+  RUN_TEST(test_mixer_matrix_custom_rules);
+  RUN_TEST(test_mixer_matrix_error_bound);
+  RUN_TEST(test_mixer_update_custom);
+  RUN_TEST(test_output_curve_inactive);
+  RUN_TEST(test_output_curve_thrust_linear);
+  RUN_TEST(test_output_curve_sag_compensation);
+  RUN_TEST(test_output_curve_sag_under_throttle);
+  RUN_TEST(test_mixer_output_curve_limit);
   UNITY_END();
 
   return 0;
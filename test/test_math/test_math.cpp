@@ -5,11 +5,26 @@
 #include "msp/msp_protocol.h"
 #include "Math/Utils.h"
 #include "Math/Bits.h"
+#include "Math/SinCos.h"
+#include "Math/SdftAnalyzer.h"
+#include "Math/FFTAnalyzer.h"
+#include "Math/FFTReal.h"
 #include "Filter.h"
+#include "FilterBank3.h"
+#include "FilterFixed.h"
+#include "FilterChain.h"
+#include "Math/FixedPoint.h"
+#include "RpmFilter.h"
 #include "Control/Pid.h"
+#include "Control/Pid3.h"
 #include "Target/QueueAtomic.h"
+#include "Target/Queue.h"
+#include "Target/SeqLock.h"
 #include "Utils/RingBuf.h"
+#include "Utils/Histogram.h"
 #include <printf.h>
+#include <complex>
+#include <thread>
 
 // void setUp(void) {
 // // set stuff up here
@@ -139,6 +154,14 @@ void test_math_clock_align()
   TEST_ASSERT_EQUAL_INT( 476, Math::alignToClock(6667,  500));
 }
 
+// peakDetect() result is not ordered
+static void sort_peaks_by_value(Math::Peak * peaks, size_t count)
+{
+  std::sort(peaks, peaks + count, [](const Math::Peak& a, const Math::Peak& b) {
+    return a.value > b.value || (a.value == b.value && a.freq < b.freq);
+  });
+}
+
 void test_math_peak_detect_full()
 {
   using Math::Peak;
@@ -147,6 +170,7 @@ void test_math_peak_detect_full()
   Peak peaks[8] = { Peak(), Peak(), Peak(), Peak() };
 
   Math::peakDetect(samples, 1, 14, 1, peaks, 4);
+  sort_peaks_by_value(peaks, 4);
 
   TEST_ASSERT_FLOAT_WITHIN(0.01f,  1.f, peaks[0].freq);
   TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.f, peaks[0].value);
@@ -169,6 +193,7 @@ void test_math_peak_detect_partial()
   Peak peaks[8] = { Peak(), Peak(), Peak(), Peak() };
 
   Math::peakDetect(samples, 3, 12, 1, peaks, 3);
+  sort_peaks_by_value(peaks, 3);
 
   TEST_ASSERT_FLOAT_WITHIN(0.01f, 7.92f, peaks[0].freq);
   TEST_ASSERT_FLOAT_WITHIN(0.01f,   5.f, peaks[0].value);
@@ -180,6 +205,77 @@ void test_math_peak_detect_partial()
   TEST_ASSERT_FLOAT_WITHIN(0.01f,   4.f, peaks[2].value);
 }
 
+void test_math_peak_detect_keeps_strongest()
+{
+  using Math::Peak;
+
+  float samples[16] = { 0, 1, 0, 3, 0, 2, 0, 5, 0, 4, 0, 0 };
+  Peak peaks[2] = { Peak(), Peak() };
+
+  Math::peakDetect(samples, 1, 10, 1, peaks, 2);
+  sort_peaks_by_value(peaks, 2);
+
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 7.f, peaks[0].freq);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 5.f, peaks[0].value);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 9.f, peaks[1].freq);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 4.f, peaks[1].value);
+}
+
+void test_math_peak_offset()
+{
+  // symmetric neighbours
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.f, Math::peakOffset(1.f, 2.f, 1.f, Math::PEAK_INTERP_WEIGHTED));
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.f, Math::peakOffset(1.f, 2.f, 1.f, Math::PEAK_INTERP_QUADRATIC));
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.f, Math::peakOffset(1.f, 2.f, 1.f, Math::PEAK_INTERP_GAUSSIAN));
+
+  // samples of parabola y = 4 - (x - 0.25)^2 at -1, 0, 1
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.25f, Math::peakOffset(2.4375f, 3.9375f, 3.4375f, Math::PEAK_INTERP_QUADRATIC));
+  // samples of gaussian y = exp(-(x + 0.3)^2) at -1, 0, 1
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, -0.3f, Math::peakOffset(expf(-0.49f), expf(-0.09f), expf(-1.69f), Math::PEAK_INTERP_GAUSSIAN));
+
+  // gaussian falls back to quadratic without positive neighbours
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.f / 6, Math::peakOffset(0.f, 1.f, 0.5f, Math::PEAK_INTERP_GAUSSIAN));
+}
+
+// worst frequency error of windowed fft peak over tones in 100..350Hz at 1kHz
+template<size_t N>
+float fft_peak_error(Math::PeakInterpolation interp)
+{
+  const float rate = 1000.f;
+  const float binWidth = rate / N;
+  float data[N], win[N];
+  Math::FFTReal<N>::begin();
+  for(size_t i = 0; i < N; i++) win[i] = 0.5f - 0.5f * cosf(2.f * Math::pi() * i / (N - 1));
+
+  float maxError = 0.f;
+  for(float freq = 100.f; freq < 350.f; freq += 3.7f)
+  {
+    for(size_t i = 0; i < N; i++) data[i] = win[i] * sinf(2.f * Math::pi() * freq * i / rate + 0.3f);
+    Math::FFTReal<N>::forward(data);
+    for(size_t j = 1; j < N / 2; j++) data[j] = sqrtf(data[2 * j] * data[2 * j] + data[2 * j + 1] * data[2 * j + 1]);
+    Math::Peak peak;
+    Math::peakDetect(data, 2, N / 2 - 2, binWidth, &peak, 1, interp);
+    maxError = std::max(maxError, std::abs(peak.freq - freq));
+  }
+  return maxError;
+}
+
+void test_math_peak_interpolation_accuracy()
+{
+  const float weighted128 = fft_peak_error<128>(Math::PEAK_INTERP_WEIGHTED);
+  const float quadratic128 = fft_peak_error<128>(Math::PEAK_INTERP_QUADRATIC);
+  const float gaussian128 = fft_peak_error<128>(Math::PEAK_INTERP_GAUSSIAN);
+  const float gaussian64 = fft_peak_error<64>(Math::PEAK_INTERP_GAUSSIAN);
+
+  // 7.8Hz bins at 128 samples, 15.6Hz at 64 samples
+  TEST_ASSERT_TRUE(quadratic128 < weighted128);
+  TEST_ASSERT_TRUE(gaussian128 < quadratic128);
+  TEST_ASSERT_TRUE(gaussian128 < 0.2f);
+  // smaller fft with gaussian fit is more accurate than weighted average on larger one
+  TEST_ASSERT_TRUE(gaussian64 < weighted128);
+  TEST_ASSERT_TRUE(gaussian64 < 0.4f);
+}
+
 void test_math_peak_sort()
 {
   using Math::Peak;
@@ -194,6 +290,172 @@ void test_math_peak_sort()
   TEST_ASSERT_FLOAT_WITHIN(0.01f,  0.f, peaks[3].freq);
 }
 
+template<size_t N>
+void assert_fft_real_matches_dft()
+{
+  float data[N], input[N];
+  for(size_t i = 0; i < N; i++)
+  {
+    input[i] = data[i] = sinf(i * 0.37f) + 0.5f * cosf(i * 1.91f) + 0.25f * (float)((i * 7919) % 17) / 17.f;
+  }
+  Math::FFTReal<N>::begin();
+  Math::FFTReal<N>::forward(data);
+
+  for(size_t k = 0; k <= N / 2; k++)
+  {
+    double re = 0, im = 0;
+    for(size_t n = 0; n < N; n++)
+    {
+      re += input[n] * cos(2 * M_PI * k * n / N);
+      im -= input[n] * sin(2 * M_PI * k * n / N);
+    }
+    if(k == 0)
+    {
+      TEST_ASSERT_FLOAT_WITHIN(1e-3f, re, data[0]);
+    }
+    else if(k == N / 2)
+    {
+      TEST_ASSERT_FLOAT_WITHIN(1e-3f, re, data[1]);
+    }
+    else
+    {
+      TEST_ASSERT_FLOAT_WITHIN(1e-3f, re, data[2 * k]);
+      TEST_ASSERT_FLOAT_WITHIN(1e-3f, im, data[2 * k + 1]);
+    }
+  }
+}
+
+void test_math_fft_real_matches_dft()
+{
+  assert_fft_real_matches_dft<8>();
+  assert_fft_real_matches_dft<16>();
+  assert_fft_real_matches_dft<128>();
+  assert_fft_real_matches_dft<256>();
+}
+
+void test_math_fft_analyzer_peaks()
+{
+  static Math::FFTAnalyzer<128> analyzer;
+  analyzer.begin(1000, DynamicFilterConfig(4, 300, 80, 400), 0);
+
+  int updates = 0;
+  for(size_t i = 0; i < 1000; i++)
+  {
+    const float t = (float)i / 1000;
+    updates += analyzer.update(sinf(2.f * Math::pi() * 270.f * t) + 0.5f * sinf(2.f * Math::pi() * 120.f * t));
+  }
+
+  // one spectrum per 128 samples
+  TEST_ASSERT_EQUAL_INT(7, updates);
+  TEST_ASSERT_FLOAT_WITHIN(4.f, 120.f, analyzer.peaks[0].freq);
+  TEST_ASSERT_FLOAT_WITHIN(4.f, 270.f, analyzer.peaks[1].freq);
+  TEST_ASSERT_TRUE(analyzer.peaks[1].value > analyzer.peaks[0].value);
+}
+
+void test_math_fft_analyzer_budget()
+{
+  static Math::FFTAnalyzer<128> whole, sliced;
+  whole.begin(1000, DynamicFilterConfig(4, 300, 80, 400, 0), 0);
+  sliced.begin(1000, DynamicFilterConfig(4, 300, 80, 400, 3), 0);
+  TEST_ASSERT_EQUAL_UINT32(0, whole.budget());
+  TEST_ASSERT_EQUAL_UINT32(3, sliced.budget());
+  // window 8, fft 8, magnitude 3, peaks 3, publish 1
+  TEST_ASSERT_EQUAL_UINT32(23, sliced.units());
+
+  const size_t lag = (sliced.units() + 2) / 3 - 1;
+  int wholeUpdates = 0, slicedUpdates = 0;
+  Math::Peak expected[Math::FFTAnalyzer<128>::PEAKS_MAX];
+  for(size_t i = 0; i < 1000; i++)
+  {
+    const float t = (float)i / 1000;
+    const float v = sinf(2.f * Math::pi() * 270.f * t) + 0.5f * sinf(2.f * Math::pi() * 180.f * t);
+    if(whole.update(v))
+    {
+      wholeUpdates++;
+      std::copy(whole.peaks, whole.peaks + 4, expected);
+      TEST_ASSERT_EQUAL_INT(0, sliced.update(v));
+      continue;
+    }
+    if(sliced.update(v))
+    {
+      slicedUpdates++;
+      // published after fixed number of samples, with same result
+      TEST_ASSERT_EQUAL_UINT32((i + 1) % 128, lag);
+      for(size_t p = 0; p < 4; p++)
+      {
+        TEST_ASSERT_EQUAL_FLOAT(expected[p].freq, sliced.peaks[p].freq);
+        TEST_ASSERT_EQUAL_FLOAT(expected[p].value, sliced.peaks[p].value);
+      }
+    }
+  }
+
+  TEST_ASSERT_EQUAL_INT(7, wholeUpdates);
+  TEST_ASSERT_EQUAL_INT(7, slicedUpdates);
+  // sorted by freq, two strongest are the tones, rest is window leakage
+  TEST_ASSERT_FLOAT_WITHIN(4.f, 180.f, sliced.peaks[2].freq);
+  TEST_ASSERT_FLOAT_WITHIN(4.f, 270.f, sliced.peaks[3].freq);
+  TEST_ASSERT_TRUE(sliced.peaks[0].value < 0.01f * sliced.peaks[2].value);
+  TEST_ASSERT_TRUE(sliced.peaks[1].value < 0.01f * sliced.peaks[2].value);
+}
+
+void test_math_fft_analyzer_small_size()
+{
+  static Math::FFTAnalyzer<64> fft;
+  static Math::SdftAnalyzer<64> sdft;
+  fft.begin(1000, DynamicFilterConfig(1, 300, 80, 400), 0);
+  sdft.begin(1000, DynamicFilterConfig(1, 300, 80, 400), 0);
+
+  for(size_t i = 0; i < 1000; i++)
+  {
+    const float v = sinf(2.f * Math::pi() * 183.3f * i / 1000);
+    fft.update(v);
+    sdft.update(v);
+  }
+
+  // 15.6Hz bins
+  TEST_ASSERT_FLOAT_WITHIN(1.f, 183.3f, fft.peaks[0].freq);
+  TEST_ASSERT_FLOAT_WITHIN(1.f, 183.3f, sdft.peaks[0].freq);
+}
+
+void test_math_sdft_analyzer_single_tone()
+{
+  static Math::SdftAnalyzer<128> analyzer;
+  analyzer.begin(1000, DynamicFilterConfig(4, 300, 80, 400), 0);
+
+  int updates = 0;
+  for(size_t i = 0; i < 1000; i++)
+  {
+    updates += analyzer.update(sinf(2.f * Math::pi() * 150.f * i / 1000) + 0.1f * sinf(2.f * Math::pi() * 3.f * i / 1000));
+  }
+
+  // one sweep per 42 samples, 80..400Hz with 7.8Hz bins
+  TEST_ASSERT_INT_WITHIN(1, 1000 / 42, updates);
+  // window leakage may add small side peaks, strongest one must be the tone
+  const Math::Peak * strongest = std::max_element(analyzer.peaks, analyzer.peaks + 4, [](const Math::Peak& a, const Math::Peak& b) { return a.value < b.value; });
+  TEST_ASSERT_FLOAT_WITHIN(4.f, 150.f, strongest->freq);
+  for(size_t i = 0; i < 4; i++)
+  {
+    if(&analyzer.peaks[i] != strongest) TEST_ASSERT_TRUE(analyzer.peaks[i].value < 0.05f * strongest->value);
+  }
+}
+
+void test_math_sdft_analyzer_two_tones()
+{
+  static Math::SdftAnalyzer<128> analyzer;
+  analyzer.begin(1000, DynamicFilterConfig(4, 300, 80, 400), 2);
+
+  for(size_t i = 0; i < 2000; i++)
+  {
+    const float t = (float)i / 1000;
+    analyzer.update(sinf(2.f * Math::pi() * 270.f * t) + 0.5f * sinf(2.f * Math::pi() * 120.f * t));
+  }
+
+  // sorted by freq
+  TEST_ASSERT_FLOAT_WITHIN(4.f, 120.f, analyzer.peaks[0].freq);
+  TEST_ASSERT_FLOAT_WITHIN(4.f, 270.f, analyzer.peaks[1].freq);
+  TEST_ASSERT_TRUE(analyzer.peaks[1].value > analyzer.peaks[0].value);
+}
+
 void test_vector_int16_access()
 {
   VectorInt16 v;
@@ -707,6 +969,479 @@ void test_filter_fir2_on()
   TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.000f, filter.update(1.0f));
 }
 
+void assert_filter_bank3_equal(const FilterConfig& config, int rate)
+{
+  Filter filter[3];
+  FilterBank3 bank;
+  for(size_t i = 0; i < 3; i++) filter[i].begin(config, rate);
+  bank.begin(config, rate);
+  for(size_t n = 0; n < 32; n++)
+  {
+    const VectorFloat v(n % 5 == 0 ? 1.0f : 0.0f, (n & 1) ? 0.5f : -0.5f, n * 0.1f);
+    const VectorFloat r = bank.update(v);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, filter[0].update(v.x), r.x);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, filter[1].update(v.y), r.y);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, filter[2].update(v.z), r.z);
+  }
+}
+
+void test_filter_bank3_matches_filter()
+{
+  assert_filter_bank3_equal(FilterConfig(FILTER_NONE, 0), 1000);
+  assert_filter_bank3_equal(FilterConfig(FILTER_PT1, 50), 1000);
+  assert_filter_bank3_equal(FilterConfig(FILTER_PT2, 50), 1000);
+  assert_filter_bank3_equal(FilterConfig(FILTER_PT3, 50), 1000);
+  assert_filter_bank3_equal(FilterConfig(FILTER_BIQUAD, 50), 1000);
+  assert_filter_bank3_equal(FilterConfig(FILTER_NOTCH, 200, 150), 1000);
+  assert_filter_bank3_equal(FilterConfig(FILTER_NOTCH_DF1, 200, 150), 1000);
+  assert_filter_bank3_equal(FilterConfig(FILTER_BPF, 200, 150), 1000);
+  assert_filter_bank3_equal(FilterConfig(FILTER_FO, 50), 1000);
+  assert_filter_bank3_equal(FilterConfig(FILTER_FIR2, 1), 1000);
+  assert_filter_bank3_equal(FilterConfig(FILTER_MEDIAN3, 1), 1000);
+}
+
+void test_filter_bank3_off()
+{
+  FilterBank3 bank;
+  bank.begin(FilterConfig(FILTER_PT1, 0), 1000);
+  TEST_ASSERT_EQUAL_INT(FILTER_NONE, bank.type());
+  const VectorFloat r = bank.update(VectorFloat(1.0f, 2.0f, 3.0f));
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.0f, r.x);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 2.0f, r.y);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 3.0f, r.z);
+}
+
+void test_filter_bank3_reconfigure_axis()
+{
+  Filter filter[3];
+  FilterBank3 bank;
+  const FilterConfig config(FILTER_NOTCH_DF1, 400, 380);
+  for(size_t i = 0; i < 3; i++) filter[i].begin(config, 1000);
+  bank.begin(config, 1000);
+
+  filter[1].reconfigure(150, 150, 2.0f);
+  bank.reconfigureAxis(1, 150, 150, 2.0f);
+  filter[2].reconfigure(200, 190, 1.5f, 0.5f);
+  bank.reconfigureAxis(2, 200, 190, 1.5f, 0.5f);
+
+  for(size_t n = 0; n < 16; n++)
+  {
+    const float s = n % 3 == 0 ? 1.0f : -0.25f;
+    const VectorFloat r = bank.update(VectorFloat(s, s, s));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, filter[0].update(s), r.x);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, filter[1].update(s), r.y);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, filter[2].update(s), r.z);
+  }
+}
+
+void test_filter_bank3_copy_coefs()
+{
+  FilterBank3 bank;
+  bank.begin(FilterConfig(FILTER_NOTCH_DF1, 400, 380), 1000);
+  bank.reconfigureAxis(0, 150, 140, 3.0f, 0.8f);
+  bank.copyCoefs(0);
+
+  for(size_t n = 0; n < 16; n++)
+  {
+    const float s = n % 4 == 0 ? 1.0f : 0.0f;
+    const VectorFloat r = bank.update(VectorFloat(s, s, s));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, r.x, r.y);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, r.x, r.z);
+  }
+}
+
+void test_rpm_filter_matches_filter()
+{
+#if defined(ESPFC_FIXED_POINT)
+  const float tolerance = 0.0005f; // Q16.16 rounding accumulates over stages
+#else
+  const float tolerance = 0.0001f;
+#endif
+  const int rate = 2000;
+  const float q = 5.0f;
+  Filter filter[RpmFilter::MOTORS][2][3];
+  RpmFilter bank;
+  bank.begin(rate, 2);
+  TEST_ASSERT_EQUAL_INT(RpmFilter::MOTORS * 2, bank.stages());
+
+  for(size_t m = 0; m < RpmFilter::MOTORS; m++)
+  {
+    for(size_t n = 0; n < 2; n++)
+    {
+      const int freq = 120 * (m + 1) * (n + 1);
+      const float weight = n == 0 ? 1.0f : 0.6f;
+      bank.reconfigure(m, n, freq, q, weight);
+      for(size_t i = 0; i < 3; i++)
+      {
+        filter[m][n][i].begin(FilterConfig(FILTER_NOTCH_DF1, freq, freq), rate);
+        filter[m][n][i].reconfigure(freq, freq, q, weight);
+      }
+    }
+  }
+
+  for(size_t k = 0; k < 64; k++)
+  {
+    const VectorFloat in(sinf(k * 0.7f), k % 3 == 0 ? 1.0f : -0.5f, cosf(k * 0.2f));
+    VectorFloat expected = in;
+    for(size_t m = 0; m < RpmFilter::MOTORS; m++)
+    {
+      for(size_t n = 0; n < 2; n++)
+      {
+        expected.x = filter[m][n][0].update(expected.x);
+        expected.y = filter[m][n][1].update(expected.y);
+        expected.z = filter[m][n][2].update(expected.z);
+      }
+    }
+    const VectorFloat r = bank.update(in);
+    TEST_ASSERT_FLOAT_WITHIN(tolerance, expected.x, r.x);
+    TEST_ASSERT_FLOAT_WITHIN(tolerance, expected.y, r.y);
+    TEST_ASSERT_FLOAT_WITHIN(tolerance, expected.z, r.z);
+  }
+}
+
+void test_rpm_filter_pass_through()
+{
+  RpmFilter bank;
+  bank.begin(1000, 0);
+  TEST_ASSERT_EQUAL_INT(0, bank.stages());
+  VectorFloat r = bank.update(VectorFloat(1.0f, 2.0f, 3.0f));
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.0f, r.x);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 2.0f, r.y);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 3.0f, r.z);
+
+  // zero weight or freq keeps input untouched
+  bank.begin(1000, 1);
+  bank.reconfigure(0, 0, 100.0f, 5.0f, 0.0f);
+  bank.reconfigure(1, 0, 0.0f, 5.0f);
+  bank.reconfigure(2, 0, 100.0f, 5.0f, 0.0f);
+  bank.reconfigure(3, 0, 100.0f, 5.0f, 0.0f);
+  for(size_t k = 0; k < 8; k++)
+  {
+    r = bank.update(VectorFloat(1.0f, -2.0f, 3.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.0f, r.x);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, -2.0f, r.y);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 3.0f, r.z);
+  }
+}
+
+void test_rpm_filter_ramp()
+{
+  RpmFilter ramped, instant;
+  ramped.begin(1000, 1, 4);
+  instant.begin(1000, 1);
+  for(size_t m = 0; m < RpmFilter::MOTORS; m++)
+  {
+    ramped.reconfigure(m, 0, 100.0f + m * 50, 5.0f);
+    instant.reconfigure(m, 0, 100.0f + m * 50, 5.0f);
+  }
+  for(size_t k = 0; k < 4; k++) ramped.update(VectorFloat());
+
+  // retune, coefficients move gradually, so response differs from instant switch
+  ramped.reconfigure(1, 0, 300.0f, 3.0f, 0.5f);
+  instant.reconfigure(1, 0, 300.0f, 3.0f, 0.5f);
+  ramped.reset();
+  instant.reset();
+  const VectorFloat in(1.0f, -1.0f, 0.5f);
+  VectorFloat r = ramped.update(in);
+  VectorFloat e = instant.update(in);
+  TEST_ASSERT_TRUE(std::abs(r.x - e.x) > 0.001f);
+  for(size_t k = 0; k < 3; k++) ramped.update(in);
+
+  // ramp finished, coefficients equal to target
+  ramped.reset();
+  instant.reset();
+  for(size_t k = 0; k < 16; k++)
+  {
+    const VectorFloat v(sinf(k), cosf(k), k % 2 ? 1.0f : 0.0f);
+    r = ramped.update(v);
+    e = instant.update(v);
+    TEST_ASSERT_FLOAT_WITHIN(0.00001f, e.x, r.x);
+    TEST_ASSERT_FLOAT_WITHIN(0.00001f, e.y, r.y);
+    TEST_ASSERT_FLOAT_WITHIN(0.00001f, e.z, r.z);
+  }
+}
+
+void test_filter_bank3_ramp()
+{
+  FilterBank3 ramped, instant;
+  const FilterConfig config(FILTER_NOTCH_DF1, 400, 380);
+  ramped.begin(config, 1000);
+  instant.begin(config, 1000);
+  ramped.setRamp(5);
+
+  ramped.reconfigureAxis(2, 150, 150, 3.0f);
+  instant.reconfigureAxis(2, 150, 150, 3.0f);
+  const VectorFloat in(1.0f, 1.0f, 1.0f);
+  VectorFloat r = ramped.update(in);
+  VectorFloat e = instant.update(in);
+  TEST_ASSERT_FLOAT_WITHIN(0.00001f, e.x, r.x);
+  TEST_ASSERT_TRUE(std::abs(r.z - e.z) > 0.001f);
+  for(size_t k = 0; k < 4; k++) ramped.update(in);
+
+  ramped.reset();
+  instant.reset();
+  for(size_t k = 0; k < 16; k++)
+  {
+    const float s = k % 3 == 0 ? 1.0f : -0.25f;
+    r = ramped.update(VectorFloat(s, s, s));
+    e = instant.update(VectorFloat(s, s, s));
+    TEST_ASSERT_FLOAT_WITHIN(0.00001f, e.x, r.x);
+    TEST_ASSERT_FLOAT_WITHIN(0.00001f, e.y, r.y);
+    TEST_ASSERT_FLOAT_WITHIN(0.00001f, e.z, r.z);
+  }
+}
+
+template<int digit>
+struct ChainDigitStage
+{
+  static void apply(int& calls, int& v) { v = v * 10 + digit; calls++; }
+};
+
+template<size_t mask>
+using TestChain = FilterChain<int, int,
+  FilterStageIf<(mask & 1) != 0, ChainDigitStage<1>>,
+  ChainDigitStage<2>,
+  FilterStageIf<(mask & 2) != 0, ChainDigitStage<3>>
+>;
+
+void test_filter_chain()
+{
+  typedef FilterChainSelector<int, int, TestChain, 2> Selector;
+  TEST_ASSERT_EQUAL_INT(4, Selector::COUNT);
+
+  const int expected[] = { 2, 12, 23, 123 };
+  const int expectedCalls[] = { 1, 2, 2, 3 };
+  for(size_t mask = 0; mask < Selector::COUNT; mask++)
+  {
+    int calls = 0, v = 0;
+    Selector::select(mask)(calls, v);
+    TEST_ASSERT_EQUAL_INT(expected[mask], v);
+    TEST_ASSERT_EQUAL_INT(expectedCalls[mask], calls);
+  }
+}
+
+void test_math_fixed_point()
+{
+  TEST_ASSERT_EQUAL_INT32(65536, Math::toQ16(1.0f));
+  TEST_ASSERT_EQUAL_INT32(-98304, Math::toQ16(-1.5f));
+  TEST_ASSERT_FLOAT_WITHIN(0.00002f, 12.345f, Math::fromQ16(Math::toQ16(12.345f)));
+  TEST_ASSERT_EQUAL_INT32(INT32_MAX, Math::toQ16(40000.0f));
+  TEST_ASSERT_EQUAL_INT32(INT32_MIN, Math::toQ16(-40000.0f));
+
+  TEST_ASSERT_EQUAL_INT32(1 << 30, Math::toQ30(1.0f));
+  TEST_ASSERT_EQUAL_INT32(Math::toQ16(-0.75f), Math::mulQ30(Math::toQ16(1.5f), Math::toQ30(-0.5f)));
+  TEST_ASSERT_EQUAL_INT32(Math::toQ16(0.25f), Math::mulQ31(Math::toQ16(1.0f), Math::toQ31(0.25f)));
+  TEST_ASSERT_EQUAL_INT32(INT32_MAX, Math::toQ31(1.0f));
+}
+
+void assert_filter_fixed_error(const FilterConfig& config, int rate, float maxError)
+{
+  Filter filter;
+  FilterFixed fixed;
+  filter.begin(config, rate);
+  fixed.begin(config, rate);
+  TEST_ASSERT_EQUAL_INT(filter._conf.type, fixed.type());
+
+  // gyro like signal, 300dps, with noise and steps
+  float err = 0.f;
+  for(size_t n = 0; n < 2000; n++)
+  {
+    const float v = 5.0f * sinf(n * 0.01f) + 0.5f * sinf(n * 1.3f) + (n % 400 < 200 ? 1.0f : -1.0f);
+    err = std::max(err, std::abs(filter.update(v) - fixed.update(v)));
+  }
+  TEST_ASSERT_FLOAT_WITHIN(maxError, 0.f, err);
+}
+
+void test_filter_fixed_matches_filter()
+{
+  assert_filter_fixed_error(FilterConfig(FILTER_NONE, 0), 1000, 0.f);
+  assert_filter_fixed_error(FilterConfig(FILTER_PT1, 100), 8000, 0.0005f);
+  assert_filter_fixed_error(FilterConfig(FILTER_PT1, 10), 8000, 0.0005f);
+  assert_filter_fixed_error(FilterConfig(FILTER_PT2, 100), 8000, 0.0005f);
+  assert_filter_fixed_error(FilterConfig(FILTER_PT3, 100), 8000, 0.0005f);
+  assert_filter_fixed_error(FilterConfig(FILTER_BIQUAD, 100), 8000, 0.001f);
+  assert_filter_fixed_error(FilterConfig(FILTER_NOTCH, 200, 150), 1000, 0.0005f);
+  assert_filter_fixed_error(FilterConfig(FILTER_NOTCH_DF1, 200, 190), 8000, 0.001f);
+  assert_filter_fixed_error(FilterConfig(FILTER_BPF, 200, 150), 1000, 0.0005f);
+  assert_filter_fixed_error(FilterConfig(FILTER_FO, 150), 8000, 0.0005f);
+  assert_filter_fixed_error(FilterConfig(FILTER_FIR2, 1), 1000, 0.0001f);
+  assert_filter_fixed_error(FilterConfig(FILTER_MEDIAN3, 1), 1000, 0.0001f);
+}
+
+void test_filter_fixed_weight()
+{
+  Filter filter;
+  FilterFixed fixed;
+  filter.begin(FilterConfig(FILTER_NOTCH_DF1, 100, 100), 1000);
+  fixed.begin(FilterConfig(FILTER_NOTCH_DF1, 100, 100), 1000);
+  filter.reconfigure(150, 150, 3.0f, 0.4f);
+  fixed.reconfigure(150, 150, 3.0f, 0.4f);
+  for(size_t n = 0; n < 100; n++)
+  {
+    const float v = n % 7 == 0 ? 2.0f : -0.3f;
+    TEST_ASSERT_FLOAT_WITHIN(0.0005f, filter.update(v), fixed.update(v));
+  }
+}
+
+void test_math_sin_cos_table()
+{
+  float maxErr = 0.f;
+  for(size_t i = 0; i <= 10000; i++)
+  {
+    const float x = i * Math::pi() / 10000;
+    float s, c;
+    Math::sinCos(x, s, c);
+    maxErr = std::max(maxErr, std::max(std::abs(s - sinf(x)), std::abs(c - cosf(x))));
+  }
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.f, maxErr);
+
+  float s, c;
+  Math::sinCos(-1.f, s, c);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.f, s);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.f, c);
+  Math::sinCos(4.f, s, c);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.f, s);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, -1.f, c);
+}
+
+void test_filter_biquad_init_notch_table()
+{
+  for(int freq = 50; freq < 3900; freq += 37)
+  {
+    for(float q : { 0.5f, 3.0f, 30.0f })
+    {
+      FilterStateBiquad exact, fast;
+      exact.init(BIQUAD_FILTER_NOTCH, 8000, freq, q);
+      fast.initNotch(8000, freq, q);
+      TEST_ASSERT_FLOAT_WITHIN(2e-5f, exact.b0, fast.b0);
+      TEST_ASSERT_FLOAT_WITHIN(2e-5f, exact.b1, fast.b1);
+      TEST_ASSERT_FLOAT_WITHIN(2e-5f, exact.b2, fast.b2);
+      TEST_ASSERT_FLOAT_WITHIN(2e-5f, exact.a1, fast.a1);
+      TEST_ASSERT_FLOAT_WITHIN(2e-5f, exact.a2, fast.a2);
+    }
+  }
+}
+
+// reference group delay [samples], numeric derivative of phase of w * B / A + (1 - w)
+static float numericGroupDelay(const float * b, const float * a, float weight, float omega)
+{
+  auto h = [&](double w) {
+    const std::complex<double> z1 = std::polar(1.0, -w), z2 = z1 * z1;
+    return (double)weight * ((double)b[0] + (double)b[1] * z1 + (double)b[2] * z2) / (1.0 + (double)a[0] * z1 + (double)a[1] * z2) + (1.0 - weight);
+  };
+  const double d = 1e-5;
+  return -std::arg(h(omega + d) / h(omega - d)) / (2 * d);
+}
+
+void test_filter_group_delay_pt1()
+{
+  Filter filter;
+  filter.begin(FilterConfig(FILTER_PT1, 100), 1000);
+  const float p = 1.f - filter._state.pt1.k;
+  for(float freq : { 1.f, 20.f, 100.f, 400.f })
+  {
+    const float w = 2.f * Math::pi() * freq / 1000;
+    const float expected = (p * cosf(w) - p * p) / (1.f - 2.f * p * cosf(w) + p * p) / 1000;
+    TEST_ASSERT_FLOAT_WITHIN(1e-7f, expected, filter.getGroupDelay(freq));
+  }
+  // approaches rc time constant at low frequency
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.f / (2.f * Math::pi() * 100), filter.getGroupDelay(0.1f));
+}
+
+void test_filter_group_delay_matches_response()
+{
+  struct { FilterConfig conf; int rate; } cases[] = {
+    { FilterConfig(FILTER_PT2, 100), 1000 },
+    { FilterConfig(FILTER_PT3, 100), 1000 },
+    { FilterConfig(FILTER_BIQUAD, 100), 1000 },
+    { FilterConfig(FILTER_NOTCH, 200, 150), 1000 },
+    { FilterConfig(FILTER_NOTCH_DF1, 200, 150), 1000 },
+    { FilterConfig(FILTER_BPF, 200, 150), 1000 },
+    { FilterConfig(FILTER_FO, 150), 8000 },
+  };
+  for(const auto& c : cases)
+  {
+    Filter filter;
+    filter.begin(c.conf, c.rate);
+    if(c.conf.type == FILTER_NOTCH_DF1) filter.setWeight(0.4f);
+    for(float freq : { 10.f, 50.f, 120.f, 300.f })
+    {
+      const float omega = 2.f * Math::pi() * freq / c.rate;
+      float expected;
+      switch(c.conf.type)
+      {
+        case FILTER_PT2:
+        case FILTER_PT3:
+        {
+          const float k = c.conf.type == FILTER_PT2 ? filter._state.pt2.k : filter._state.pt3.k;
+          const float b[3] = { k, 0.f, 0.f }, a[2] = { k - 1.f, 0.f };
+          expected = numericGroupDelay(b, a, 1.f, omega) * (c.conf.type == FILTER_PT2 ? 2 : 3);
+          break;
+        }
+        case FILTER_FO:
+        {
+          const float b[3] = { filter._state.fo.b0, filter._state.fo.b1, 0.f }, a[2] = { filter._state.fo.a1, 0.f };
+          expected = numericGroupDelay(b, a, 1.f, omega);
+          break;
+        }
+        default:
+        {
+          const FilterStateBiquad& bq = filter._state.bq;
+          const float b[3] = { bq.b0, bq.b1, bq.b2 }, a[2] = { bq.a1, bq.a2 };
+          expected = numericGroupDelay(b, a, c.conf.type == FILTER_NOTCH_DF1 ? 0.4f : 1.f, omega);
+        }
+      }
+      TEST_ASSERT_FLOAT_WITHIN(0.001f, expected, filter.getGroupDelay(freq) * c.rate);
+    }
+  }
+}
+
+void test_filter_group_delay_fir_median()
+{
+  Filter filter;
+  filter.begin(FilterConfig(FILTER_FIR2, 1), 1000);
+  TEST_ASSERT_FLOAT_WITHIN(1e-9f, 0.0005f, filter.getGroupDelay(100));
+  filter.begin(FilterConfig(FILTER_MEDIAN3, 1), 1000);
+  TEST_ASSERT_FLOAT_WITHIN(1e-9f, 0.001f, filter.getGroupDelay(100));
+  filter.begin(FilterConfig(FILTER_NONE, 1), 1000);
+  TEST_ASSERT_EQUAL_FLOAT(0.f, filter.getGroupDelay(100));
+}
+
+void test_filter_group_delay_bank_fixed_rpm()
+{
+  for(const FilterConfig& conf : { FilterConfig(FILTER_PT1, 100), FilterConfig(FILTER_PT3, 100), FilterConfig(FILTER_BIQUAD, 100), FilterConfig(FILTER_NOTCH_DF1, 200, 150), FilterConfig(FILTER_FO, 150) })
+  {
+    Filter filter;
+    FilterBank3 bank;
+    FilterFixed fixed;
+    filter.begin(conf, 1000);
+    bank.begin(conf, 1000);
+    fixed.begin(conf, 1000);
+    for(float freq : { 20.f, 80.f, 250.f })
+    {
+      const float expected = filter.getGroupDelay(freq);
+      TEST_ASSERT_FLOAT_WITHIN(1e-7f, expected, bank.getGroupDelay(freq, 0));
+      TEST_ASSERT_FLOAT_WITHIN(1e-7f, expected, bank.getGroupDelay(freq, 2));
+      TEST_ASSERT_FLOAT_WITHIN(1e-6f, expected, fixed.getGroupDelay(freq));
+    }
+  }
+
+  // two stages at same freq, the rest pass through
+  RpmFilter rpm;
+  Filter notch;
+  rpm.begin(1000, 2);
+  rpm.reconfigure(0, 0, 150, 3.0f, 0.5f);
+  rpm.reconfigure(2, 1, 150, 3.0f, 0.5f);
+  notch.begin(FilterConfig(FILTER_NOTCH_DF1, 150, 100), 1000);
+  notch.reconfigure(150, 100, 3.0f, 0.5f);
+  for(float freq : { 20.f, 80.f, 250.f })
+  {
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 2.f * notch.getGroupDelay(freq), rpm.getGroupDelay(freq));
+  }
+  rpm.begin(1000, 3);
+  TEST_ASSERT_EQUAL_FLOAT(0.f, rpm.getGroupDelay(100));
+}
+
 void test_pid_init()
 {
   Pid pid;
@@ -990,6 +1725,120 @@ void test_pid_update_sum_limit()
   TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, result);
 }
 
+// same setup for reference and engine pids, axes differ in enabled terms
+static void setup_pid3_axes(Pid * pids)
+{
+  for(size_t i = 0; i < 3; i++)
+  {
+    Pid& pid = pids[i];
+    ensure(pid, 1000.f);
+    gain(pid, 0.2f, 10.f, 0.005f, 0.01f);
+    pid.dtermFilter.begin(FilterConfig(FILTER_PT1, 100), pid.rate);
+    pid.dtermFilter2.begin(FilterConfig(FILTER_BIQUAD, 150), pid.rate);
+    pid.dtermNotchFilter.begin(FilterConfig(FILTER_NOTCH, 200, 150), pid.rate);
+    pid.ftermFilter.begin(FilterConfig(FILTER_PT1, 50), pid.rate);
+    pid.itermRelaxFilter.begin(FilterConfig(FILTER_PT1, 15), pid.rate);
+    pid.begin();
+  }
+  pids[0].itermRelax = ITERM_RELAX_RP;
+  pids[1].itermRelax = ITERM_RELAX_RP_INC;
+  pids[2].Kd = 0.f;
+  pids[2].fScale = 0.f;
+}
+
+#if defined(ESPFC_FIXED_POINT)
+// integer term sums differ from float pid by rounding only
+#define TEST_ASSERT_PID3(expected, actual) TEST_ASSERT_FLOAT_WITHIN(0.0002f, expected, actual)
+#else
+#define TEST_ASSERT_PID3(expected, actual) TEST_ASSERT_EQUAL_FLOAT(expected, actual)
+#endif
+
+void test_pid3_update_matches_pid()
+{
+  Pid ref[3], pids[3];
+  setup_pid3_axes(ref);
+  setup_pid3_axes(pids);
+  Control::Pid3 pid3(pids);
+
+  for(size_t n = 0; n < 500; n++)
+  {
+    float setpoint[3], measurement[3], output[3];
+    for(size_t i = 0; i < 3; i++)
+    {
+      setpoint[i] = 0.5f * sinf(n * 0.05f + i);
+      measurement[i] = 0.4f * sinf(n * 0.05f + i - 0.3f) + 0.02f * sinf(n * 1.7f);
+    }
+    // saturation and scaler changes between updates
+    const bool saturated = (n / 50) % 3 == 1;
+    const float scale = n < 250 ? 1.f : 0.5f;
+    for(size_t i = 0; i < 3; i++)
+    {
+      ref[i].outputSaturated = pids[i].outputSaturated = saturated;
+      ref[i].dScale = pids[i].dScale = scale;
+    }
+    ref[1].iScale = pids[1].iScale = n < 400 ? 1.f : 0.f;
+
+    pid3.update(setpoint, measurement, output);
+    for(size_t i = 0; i < 3; i++)
+    {
+      const float expected = ref[i].update(setpoint[i], measurement[i]);
+      TEST_ASSERT_PID3(expected, output[i]);
+      TEST_ASSERT_PID3(ref[i].pTerm, pids[i].pTerm);
+      TEST_ASSERT_PID3(ref[i].iTerm, pids[i].iTerm);
+      TEST_ASSERT_PID3(ref[i].dTerm, pids[i].dTerm);
+      TEST_ASSERT_PID3(ref[i].fTerm, pids[i].fTerm);
+      TEST_ASSERT_PID3(ref[i].iTermError, pids[i].iTermError);
+      TEST_ASSERT_PID3(ref[i].itermRelaxFactor, pids[i].itermRelaxFactor);
+    }
+  }
+  TEST_ASSERT_EQUAL_FLOAT(0.f, pids[2].dTerm);
+  TEST_ASSERT_EQUAL_FLOAT(0.f, pids[2].fTerm);
+  TEST_ASSERT_EQUAL_FLOAT(0.f, pids[1].iTerm);
+}
+
+void test_pid3_error_bound()
+{
+  // flight gains at 8kHz, p=45 i=80 d=30 f=100, same filters as defaults
+  const float rate = 8000.f;
+  Pid ref[3], pids[3];
+  for(Pid * set : { ref, pids })
+  {
+    for(size_t i = 0; i < 3; i++)
+    {
+      Pid& pid = set[i];
+      ensure(pid, rate);
+      gain(pid, 45 * PTERM_SCALE, 80 * ITERM_SCALE, 30 * DTERM_SCALE, 100 * FTERM_SCALE);
+      pid.iLimit = 0.3f;
+      pid.oLimit = 0.66f;
+      pid.dtermFilter.begin(FilterConfig(FILTER_PT1, 100), rate);
+      pid.dtermFilter2.begin(FilterConfig(FILTER_PT1, 200), rate);
+      pid.ftermFilter.begin(FilterConfig(FILTER_PT3, 25), rate);
+      pid.itermRelaxFilter.begin(FilterConfig(FILTER_PT1, 15), rate);
+      pid.itermRelax = ITERM_RELAX_RP;
+      pid.begin();
+    }
+  }
+  Control::Pid3 pid3(pids);
+
+  // gyro like signal in rad/s, stick steps up to 600dps, motor noise
+  float err = 0.f;
+  for(size_t n = 0; n < 4000; n++)
+  {
+    float setpoint[3], measurement[3], output[3];
+    for(size_t i = 0; i < 3; i++)
+    {
+      setpoint[i] = (n % 1000 < 500 ? 10.f : -10.f) * (i + 1) / 3;
+      measurement[i] = setpoint[i] * 0.9f + 2.f * sinf(n * 0.003f + i) + 0.1f * sinf(n * 0.9f + i);
+    }
+    pid3.update(setpoint, measurement, output);
+    for(size_t i = 0; i < 3; i++)
+    {
+      err = std::max(err, std::abs(ref[i].update(setpoint[i], measurement[i]) - output[i]));
+    }
+  }
+  TEST_ASSERT_FLOAT_WITHIN(0.0002f, 0.f, err);
+}
+
 void test_queue_atomic()
 {
   QueueAtomic<int, 3> q;
@@ -1052,6 +1901,151 @@ void test_queue_atomic()
   TEST_ASSERT_FALSE(q.isFull());
 }
 
+#if defined(ESPFC_ATOMIC_QUEUE)
+static uint32_t elapsedUs(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void test_queue_receive_timeout()
+{
+  Target::Queue q;
+  q.begin();
+  Event e;
+
+  TEST_ASSERT_FALSE(q.receive(e, 0));
+
+  const auto start = std::chrono::steady_clock::now();
+  TEST_ASSERT_FALSE(q.receive(e, 20000));
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(20000, elapsedUs(start));
+
+  q.send(Event(EVENT_DISARM));
+  TEST_ASSERT_TRUE(q.receive(e, 20000));
+  TEST_ASSERT_EQUAL(EVENT_DISARM, e.type);
+}
+
+void test_queue_receive_wakeup()
+{
+  Target::Queue q;
+  q.begin();
+  Event e;
+  bool received = false;
+  uint32_t elapsed = 0;
+
+  std::thread receiver([&]() {
+    const auto start = std::chrono::steady_clock::now();
+    received = q.receive(e, 1000000);
+    elapsed = elapsedUs(start);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  q.send(Event(EVENT_GYRO_READ));
+  receiver.join();
+
+  TEST_ASSERT_TRUE(received);
+  TEST_ASSERT_EQUAL(EVENT_GYRO_READ, e.type);
+  TEST_ASSERT_LESS_THAN_UINT32(500000, elapsed);
+}
+
+void test_queue_receive_threads()
+{
+  const int count = 20000;
+  Target::Queue q;
+  q.begin();
+
+  // send() drops events when full, so producer waits for space
+  std::thread producer([&]() {
+    for(int i = 0; i < count; i++)
+    {
+      while(q.isFull()) std::this_thread::yield();
+      q.send(Event(EVENT_GYRO_READ));
+    }
+  });
+
+  // lost wakeup would end the loop on timeout
+  int received = 0;
+  Event e;
+  while(received < count && q.receive(e, 100000))
+  {
+    TEST_ASSERT_EQUAL(EVENT_GYRO_READ, e.type);
+    received++;
+  }
+  producer.join();
+
+  TEST_ASSERT_EQUAL(count, received);
+  TEST_ASSERT_TRUE(q.isEmpty());
+}
+#endif
+
+void test_seq_lock()
+{
+  SeqLock<int> s;
+  int r = 91;
+
+  // nothing written
+  TEST_ASSERT_EQUAL_UINT32(0, s.version());
+  TEST_ASSERT_FALSE(s.receive(r));
+  TEST_ASSERT_EQUAL(91, r);
+  TEST_ASSERT_EQUAL_UINT32(0, s.read(r));
+  TEST_ASSERT_EQUAL(0, r);
+
+  s.write(1);
+  TEST_ASSERT_EQUAL_UINT32(1, s.version());
+  TEST_ASSERT_TRUE(s.receive(r));
+  TEST_ASSERT_EQUAL(1, r);
+  TEST_ASSERT_FALSE(s.receive(r));
+
+  // only latest item is kept
+  s.write(2);
+  s.write(3);
+  TEST_ASSERT_EQUAL_UINT32(3, s.version());
+  TEST_ASSERT_TRUE(s.receive(r));
+  TEST_ASSERT_EQUAL(3, r);
+  TEST_ASSERT_FALSE(s.receive(r));
+
+  // read does not consume
+  TEST_ASSERT_EQUAL_UINT32(3, s.read(r));
+  TEST_ASSERT_EQUAL(3, r);
+}
+
+struct SeqLockPayload
+{
+  uint32_t seq;
+  uint32_t data[15];
+};
+
+void test_seq_lock_threads()
+{
+  SeqLock<SeqLockPayload> s;
+  const uint32_t count = 200000;
+
+  std::thread producer([&s, count]() {
+    SeqLockPayload p;
+    for(uint32_t i = 1; i <= count; i++)
+    {
+      p.seq = i;
+      for(size_t j = 0; j < 15; j++) p.data[j] = i * (j + 1);
+      s.write(p);
+    }
+  });
+
+  // every snapshot must be complete and never older than previous one
+  uint32_t last = 0, torn = 0, received = 0;
+  while(last < count)
+  {
+    SeqLockPayload p;
+    if(!s.receive(p)) continue;
+    received++;
+    for(size_t j = 0; j < 15; j++) if(p.data[j] != p.seq * (j + 1)) torn++;
+    TEST_ASSERT_TRUE(p.seq >= last);
+    last = p.seq;
+  }
+  producer.join();
+
+  TEST_ASSERT_EQUAL_UINT32(0, torn);
+  TEST_ASSERT_EQUAL_UINT32(count, last);
+  TEST_ASSERT_GREATER_THAN_UINT32(0, received);
+}
+
 void test_ring_buf()
 {
   Utils::RingBuf<uint8_t, 3> q;
@@ -1224,6 +2218,61 @@ void test_ring_buf2()
   TEST_ASSERT_EQUAL_INT32(107, y[3]);
 }
 
+void test_histogram_buckets()
+{
+  // buckets are contiguous and ordered
+  TEST_ASSERT_EQUAL_UINT32(0, Utils::Histogram::index(0));
+  TEST_ASSERT_EQUAL_UINT32(3, Utils::Histogram::index(3));
+  TEST_ASSERT_EQUAL_UINT32(4, Utils::Histogram::index(4));
+  TEST_ASSERT_EQUAL_UINT32(8, Utils::Histogram::index(8));
+  TEST_ASSERT_EQUAL_UINT32(8, Utils::Histogram::index(9));
+  TEST_ASSERT_EQUAL_UINT32(9, Utils::Histogram::index(10));
+  TEST_ASSERT_EQUAL_UINT32(Utils::Histogram::BUCKETS - 1, Utils::Histogram::index(UINT32_MAX));
+  for(size_t i = 0; i < Utils::Histogram::BUCKETS; i++)
+  {
+    const uint32_t lo = Utils::Histogram::lowerBound(i);
+    TEST_ASSERT_EQUAL_UINT32(i, Utils::Histogram::index(lo));
+    if(lo > 0) TEST_ASSERT_EQUAL_UINT32(i - 1, Utils::Histogram::index(lo - 1));
+  }
+}
+
+void test_histogram_percentile()
+{
+  Utils::Histogram h;
+  TEST_ASSERT_EQUAL_UINT32(0, h.count());
+  TEST_ASSERT_EQUAL_UINT32(0, h.min());
+  TEST_ASSERT_EQUAL_UINT32(0, h.percentile(0.5f));
+
+  // 5us average hides rare 80us spikes
+  for(size_t i = 0; i < 1000; i++) h.add(i % 100 == 0 ? 80 : 5);
+
+  TEST_ASSERT_EQUAL_UINT32(1000, h.count());
+  TEST_ASSERT_EQUAL_UINT32(5, h.min());
+  TEST_ASSERT_EQUAL_UINT32(80, h.max());
+  TEST_ASSERT_EQUAL_UINT32(5, h.percentile(0.5f));
+  TEST_ASSERT_EQUAL_UINT32(5, h.percentile(0.9f));
+  TEST_ASSERT_EQUAL_UINT32(5, h.percentile(0.98f));
+  TEST_ASSERT_EQUAL_UINT32(80, h.percentile(0.999f));
+
+  h.reset();
+  for(uint32_t i = 1; i <= 1000; i++) h.add(i);
+  TEST_ASSERT_UINT32_WITHIN(125, 500, h.percentile(0.5f));
+  TEST_ASSERT_UINT32_WITHIN(225, 900, h.percentile(0.9f));
+  TEST_ASSERT_EQUAL_UINT32(1000, h.percentile(0.999f));
+}
+
+void test_histogram_decay()
+{
+  Utils::Histogram h;
+  for(size_t i = 0; i < 100000; i++) h.add(i % 4 ? 10 : 1000);
+
+  // saturated buckets are halved, proportions are kept
+  TEST_ASSERT_EQUAL_UINT32(100000, h.count());
+  TEST_ASSERT_UINT32_WITHIN(2, 10, h.percentile(0.5f));
+  TEST_ASSERT_UINT32_WITHIN(2, 10, h.percentile(0.7f));
+  TEST_ASSERT_UINT32_WITHIN(250, 1000, h.percentile(0.8f));
+}
+
 void test_align_addr_to_write()
 {
   TEST_ASSERT_EQUAL_UINT32(  0, Math::alignAddressToWrite(  0,  8, 16));
@@ -1317,7 +2366,16 @@ int main(int argc, char **argv)
   RUN_TEST(test_math_baro_altitude);
   RUN_TEST(test_math_peak_detect_full);
   RUN_TEST(test_math_peak_detect_partial);
+  RUN_TEST(test_math_peak_detect_keeps_strongest);
+  RUN_TEST(test_math_peak_offset);
+  RUN_TEST(test_math_peak_interpolation_accuracy);
   RUN_TEST(test_math_peak_sort);
+  RUN_TEST(test_math_fft_real_matches_dft);
+  RUN_TEST(test_math_fft_analyzer_peaks);
+  RUN_TEST(test_math_fft_analyzer_budget);
+  RUN_TEST(test_math_fft_analyzer_small_size);
+  RUN_TEST(test_math_sdft_analyzer_single_tone);
+  RUN_TEST(test_math_sdft_analyzer_two_tones);
 
   RUN_TEST(test_vector_int16_access);
   RUN_TEST(test_vector_int16_math);
@@ -1353,6 +2411,24 @@ int main(int argc, char **argv)
   RUN_TEST(test_filter_notch_above_nyquist);
   RUN_TEST(test_filter_fir2_off);
   RUN_TEST(test_filter_fir2_on);
+  RUN_TEST(test_filter_bank3_matches_filter);
+  RUN_TEST(test_filter_bank3_off);
+  RUN_TEST(test_filter_bank3_reconfigure_axis);
+  RUN_TEST(test_filter_bank3_copy_coefs);
+  RUN_TEST(test_rpm_filter_matches_filter);
+  RUN_TEST(test_rpm_filter_pass_through);
+  RUN_TEST(test_rpm_filter_ramp);
+  RUN_TEST(test_filter_bank3_ramp);
+  RUN_TEST(test_filter_chain);
+  RUN_TEST(test_math_fixed_point);
+  RUN_TEST(test_filter_fixed_matches_filter);
+  RUN_TEST(test_filter_fixed_weight);
+  RUN_TEST(test_math_sin_cos_table);
+  RUN_TEST(test_filter_biquad_init_notch_table);
+  RUN_TEST(test_filter_group_delay_pt1);
+  RUN_TEST(test_filter_group_delay_matches_response);
+  RUN_TEST(test_filter_group_delay_fir_median);
+  RUN_TEST(test_filter_group_delay_bank_fixed_rpm);
 
   RUN_TEST(test_pid_init);
   RUN_TEST(test_pid_update_p);
@@ -1363,10 +2439,22 @@ int main(int argc, char **argv)
   RUN_TEST(test_pid_update_f);
   RUN_TEST(test_pid_update_sum);
   RUN_TEST(test_pid_update_sum_limit);
+  RUN_TEST(test_pid3_update_matches_pid);
+  RUN_TEST(test_pid3_error_bound);
 
   RUN_TEST(test_queue_atomic);
+#if defined(ESPFC_ATOMIC_QUEUE)
+  RUN_TEST(test_queue_receive_timeout);
+  RUN_TEST(test_queue_receive_wakeup);
+  RUN_TEST(test_queue_receive_threads);
+#endif
+  RUN_TEST(test_seq_lock);
+  RUN_TEST(test_seq_lock_threads);
   RUN_TEST(test_ring_buf);
   RUN_TEST(test_ring_buf2);
+  RUN_TEST(test_histogram_buckets);
+  RUN_TEST(test_histogram_percentile);
+  RUN_TEST(test_histogram_decay);
   RUN_TEST(test_align_addr_to_write);
 
   RUN_TEST(test_rotation_matrix_no_rotation);